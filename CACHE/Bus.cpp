@@ -1,5 +1,6 @@
 #include "Bus.h"
 #include "Cache.h"
+#include "Profiler.h"
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
@@ -7,7 +8,11 @@
 
 Bus::Bus()
     : busy(false),
-      currentCycles(0)
+      currentCycles(0),
+      contentionTracking(false),
+      filterBlockOffsetBits(5),
+      snoopsFiltered(0),
+      snoopsForwarded(0)
 {
     // Initialize the bus
 }
@@ -24,6 +29,10 @@ void Bus::registerCache(Cache* cache, int coreId) {
     
     // Register the cache
     caches[coreId] = cache;
+
+    // The snoop filter keys on block addresses, so it needs the block
+    // offset width; all caches share the same configuration
+    filterBlockOffsetBits = cache->blockOffsetBits;
 }
 
 // Modify Bus::busOperation to keep the bus busy until cycles are processed
@@ -40,14 +49,29 @@ bool Bus::busOperation(BusOperation operation, uint32_t address, int sourceId,
     
     // Process the transaction immediately
     busy = true;
+    cycles = executeTransaction(transaction, dataProvided);
+    
+    // Set the cycles for the current transaction
+    currentCycles = cycles;
+    
+    // Keep the bus busy until cycles are processed in processCycle
+    // Remove the "busy = false" line here
+    busy = false;
+    return true;
+}
+
+int Bus::executeTransaction(BusTransaction& transaction, bool& dataProvided) {
     dataProvided = false;
-    cycles = 0;
+    int cycles = 0;
     
     // Process snooping for this transaction
     processSnooping(transaction);
-    
+
+    // Keep the snoop filter in sync with the new sharer set
+    updateSnoopFilter(transaction);
+
     // Update statistics based on the operation
-    switch (operation) {
+    switch (transaction.operation) {
         case BusOperation::BusRd:
             stats.incrementBusReads();
             break;
@@ -77,7 +101,8 @@ bool Bus::busOperation(BusOperation operation, uint32_t address, int sourceId,
  
     } else {
         // Data from memory
-        if (operation == BusOperation::Flush || operation == BusOperation::FlushOpt) {
+        if (transaction.operation == BusOperation::Flush ||
+            transaction.operation == BusOperation::FlushOpt) {
             cycles = 100; // Memory writeback
         } else {
       
@@ -85,26 +110,50 @@ bool Bus::busOperation(BusOperation operation, uint32_t address, int sourceId,
         }
     }
     
-    // Set the cycles for the current transaction
-    currentCycles = cycles;
-    
+    // Per-block contention tracking for the ping-pong report
+    if (contentionTracking &&
+        (transaction.operation == BusOperation::BusRdX ||
+         transaction.operation == BusOperation::BusUpgr)) {
+        BlockContention& entry = contention[transaction.address >> filterBlockOffsetBits];
+        entry.invalidatingOps++;
+        entry.coresMask |= 1u << transaction.sourceId;
+        if (entry.lastOwner >= 0 && entry.lastOwner != transaction.sourceId) {
+            // Write ownership moved to another core: the classic ping-pong
+            // pattern; charge this transaction's full cost to it
+            entry.transitions++;
+            entry.cyclesLost += cycles;
+        }
+        entry.lastOwner = transaction.sourceId;
+    }
+
     // Update the output parameters
     dataProvided = transaction.dataProvided;
-    
-    // Keep the bus busy until cycles are processed in processCycle
-    // Remove the "busy = false" line here
-    busy = false;
-    return true;
+    return cycles;
 }
 
 // In Bus.cpp, modify the processSnooping method
 void Bus::processSnooping(BusTransaction& transaction) {
-    // Have all caches snoop this transaction
+    PROFILE_SCOPE(PHASE_BUS_SNOOP);
+    // Consult the snoop filter: only caches whose sharer bit is set can
+    // hold the line, so the broadcast only fans out to those
+
+    uint32_t blockAddress = transaction.address >> filterBlockOffsetBits;
+    uint32_t sharers = 0;
+    auto filterEntry = snoopFilter.find(blockAddress);
+    if (filterEntry != snoopFilter.end()) {
+        sharers = filterEntry->second;
+    }
 
     int totalInvalidations = 0;
-    
+
     for (size_t i = 0; i < caches.size(); i++) {
         if (caches[i] && static_cast<int>(i) != transaction.sourceId) {
+            // Skip caches the filter says cannot hold the block
+            if ((sharers & (1u << i)) == 0) {
+                snoopsFiltered++;
+                continue;
+            }
+            snoopsForwarded++;
             int initialInvalidations = caches[i]->getStatistics().getInvalidations();
             
             int snoopCycles = 0;
@@ -128,6 +177,30 @@ void Bus::processSnooping(BusTransaction& transaction) {
     
 }
 
+void Bus::updateSnoopFilter(const BusTransaction& transaction) {
+    uint32_t blockAddress = transaction.address >> filterBlockOffsetBits;
+    uint32_t sourceBit = 1u << transaction.sourceId;
+
+    switch (transaction.operation) {
+        case BusOperation::BusRd:
+            // The requester joins the sharer set
+            snoopFilter[blockAddress] |= sourceBit;
+            break;
+
+        case BusOperation::BusRdX:
+        case BusOperation::BusUpgr:
+            // All other copies were just invalidated; only the requester holds it
+            snoopFilter[blockAddress] = sourceBit;
+            break;
+
+        case BusOperation::Flush:
+        case BusOperation::FlushOpt:
+            // Writeback; the source may still keep a clean copy
+            snoopFilter[blockAddress] |= sourceBit;
+            break;
+    }
+}
+
 // Improve Bus::processCycle to handle pending transactions properly
 void Bus::processCycle() {
     // If the bus is busy, decrement the current cycles
@@ -205,7 +278,10 @@ void Bus::printStatus() const {
         std::cout << "  Cycles Remaining: " << currentCycles << std::endl;
     }
     std::cout << "  Pending Transactions: " << pendingTransactions.size() << std::endl;
-    
+    std::cout << "  Snoop Filter Entries: " << snoopFilter.size() << std::endl;
+    std::cout << "  Snoops Filtered: " << snoopsFiltered << std::endl;
+    std::cout << "  Snoops Forwarded: " << snoopsForwarded << std::endl;
+
     std::cout << "  Statistics:" << std::endl;
     std::cout << "    Bus Reads: " << stats.getBusReads() << std::endl;
     std::cout << "    Bus ReadXs: " << stats.getBusReadXs() << std::endl;
@@ -234,3 +310,62 @@ bool Bus::isBusy() const {
     return busy;
 }
 
+
+bool Bus::saveState(std::FILE* f) const {
+    if (std::fwrite(&busy, sizeof(busy), 1, f) != 1) return false;
+    if (std::fwrite(&currentCycles, sizeof(currentCycles), 1, f) != 1) return false;
+    if (std::fwrite(&busyUntilCycle, sizeof(busyUntilCycle), 1, f) != 1) return false;
+
+    // Pending transaction queue (copied, since std::queue has no iterators)
+    uint32_t pendingCount = static_cast<uint32_t>(pendingTransactions.size());
+    if (std::fwrite(&pendingCount, sizeof(pendingCount), 1, f) != 1) return false;
+    std::queue<BusTransaction> pending = pendingTransactions;
+    while (!pending.empty()) {
+        const BusTransaction& t = pending.front();
+        if (std::fwrite(&t, sizeof(BusTransaction), 1, f) != 1) return false;
+        pending.pop();
+    }
+
+    // Snoop filter contents
+    uint32_t filterCount = static_cast<uint32_t>(snoopFilter.size());
+    if (std::fwrite(&filterCount, sizeof(filterCount), 1, f) != 1) return false;
+    for (const auto& entry : snoopFilter) {
+        if (std::fwrite(&entry.first, sizeof(entry.first), 1, f) != 1) return false;
+        if (std::fwrite(&entry.second, sizeof(entry.second), 1, f) != 1) return false;
+    }
+
+    if (std::fwrite(&snoopsFiltered, sizeof(snoopsFiltered), 1, f) != 1) return false;
+    if (std::fwrite(&snoopsForwarded, sizeof(snoopsForwarded), 1, f) != 1) return false;
+    return stats.saveState(f);
+}
+
+bool Bus::loadState(std::FILE* f) {
+    if (std::fread(&busy, sizeof(busy), 1, f) != 1) return false;
+    if (std::fread(&currentCycles, sizeof(currentCycles), 1, f) != 1) return false;
+    if (std::fread(&busyUntilCycle, sizeof(busyUntilCycle), 1, f) != 1) return false;
+
+    uint32_t pendingCount = 0;
+    if (std::fread(&pendingCount, sizeof(pendingCount), 1, f) != 1) return false;
+    while (!pendingTransactions.empty()) {
+        pendingTransactions.pop();
+    }
+    for (uint32_t i = 0; i < pendingCount; i++) {
+        BusTransaction t(BusOperation::BusRd, 0, 0);
+        if (std::fread(&t, sizeof(BusTransaction), 1, f) != 1) return false;
+        pendingTransactions.push(t);
+    }
+
+    uint32_t filterCount = 0;
+    if (std::fread(&filterCount, sizeof(filterCount), 1, f) != 1) return false;
+    snoopFilter.clear();
+    for (uint32_t i = 0; i < filterCount; i++) {
+        uint32_t blockAddress = 0, sharers = 0;
+        if (std::fread(&blockAddress, sizeof(blockAddress), 1, f) != 1) return false;
+        if (std::fread(&sharers, sizeof(sharers), 1, f) != 1) return false;
+        snoopFilter[blockAddress] = sharers;
+    }
+
+    if (std::fread(&snoopsFiltered, sizeof(snoopsFiltered), 1, f) != 1) return false;
+    if (std::fread(&snoopsForwarded, sizeof(snoopsForwarded), 1, f) != 1) return false;
+    return stats.loadState(f);
+}
@@ -6,6 +6,8 @@
 #include <functional>
 #include <queue>
 #include <mutex>
+#include <unordered_map>
+#include <cstdio>
 #include "Statistics.h"
 
 extern unsigned int currentGlobalCycle;
@@ -35,7 +37,7 @@ struct BusTransaction {
 };
 
 class Bus {
-private:
+protected:
     bool busy;
     int currentCycles; // you might later remove this if not needed
     unsigned int busyUntilCycle = 0;  // <-- ADD THIS for fast-forwarding bus busy time
@@ -43,24 +45,55 @@ private:
 
     Statistics stats;
     std::queue<BusTransaction> pendingTransactions;
-    
-    // Helper methods
-    void processSnooping(BusTransaction& transaction);
-    
+
+    // Inclusive snoop filter: block address -> bitmap of cores that may
+    // hold the line. A missing entry means no cache can hold the block, so
+    // transactions only fan out to caches whose bit is set. Entries are a
+    // conservative superset (silent evictions are not tracked), which only
+    // costs an occasional unnecessary snoop, never a missed one.
+    std::unordered_map<uint32_t, uint32_t> snoopFilter;
+
+    // Per-block contention tracking for the ping-pong report (opt-in; the
+    // hot path pays one hash lookup per invalidating transaction and
+    // nothing otherwise)
+    bool contentionTracking;
+    struct BlockContention {
+        uint32_t invalidatingOps = 0;  // BusRdX/BusUpgr transactions on the block
+        uint32_t transitions = 0;      // Times write ownership moved between cores
+        uint64_t cyclesLost = 0;       // Cycles charged to ownership transfers
+        uint32_t coresMask = 0;        // Cores that ever touched the block
+        int lastOwner = -1;            // Core that last took write ownership
+    };
+    std::unordered_map<uint32_t, BlockContention> contention;
+    int filterBlockOffsetBits;        // Block offset bits, taken from the first registered cache
+    uint64_t snoopsFiltered;          // Snoops skipped thanks to the filter
+    uint64_t snoopsForwarded;         // Snoops that actually reached a cache
+
+    // Helper methods (virtual so alternative interconnects such as the
+    // directory-based engine can replace the snoop fan-out)
+    virtual void processSnooping(BusTransaction& transaction);
+    virtual void updateSnoopFilter(const BusTransaction& transaction);
+
+    // Run one transaction to completion: snoop fan-out, filter update,
+    // statistics, and latency calculation. Returns the transaction's
+    // cycle cost and sets dataProvided. Shared by the blocking bus and
+    // the split-transaction bus.
+    int executeTransaction(BusTransaction& transaction, bool& dataProvided);
+
 public:
     // Constructor and destructor
     Bus();
-    ~Bus();
+    virtual ~Bus();
     
     // Register a cache with the bus
-    void registerCache(Cache* cache, int coreId);
+    virtual void registerCache(Cache* cache, int coreId);
     
     // Perform a bus operation
-    bool busOperation(BusOperation operation, uint32_t address, int sourceId, 
-                     bool& dataProvided, int& cycles);
+    virtual bool busOperation(BusOperation operation, uint32_t address, int sourceId,
+                              bool& dataProvided, int& cycles);
     
     // Process one cycle of bus activity
-    void processCycle();
+    virtual void processCycle();
     
     // Check if bus is busy
    
@@ -82,9 +115,23 @@ public:
     while (!pendingTransactions.empty()) {
         pendingTransactions.pop();
     }
+    // Note: the snoop filter is deliberately left alone here; cache
+    // contents survive a bus reset, and the filter must stay a superset
+    // of the true sharers.
 }
-bool isBusy() const;
+virtual bool isBusy() const;
 void processNextPendingTransaction();
+
+// Checkpoint support
+virtual bool saveState(std::FILE* f) const;
+virtual bool loadState(std::FILE* f);
+
+// Per-block contention tracking (for the ping-pong analysis report)
+void setContentionTracking(bool enabled) { contentionTracking = enabled; }
+const std::unordered_map<uint32_t, BlockContention>& getContention() const {
+    return contention;
+}
+int getFilterBlockOffsetBits() const { return filterBlockOffsetBits; }
 };
 
 
@@ -1,5 +1,6 @@
 #include "Cache.h"
 #include "Bus.h"
+#include "Profiler.h"
 #include <iostream>
 #include <iomanip>
 #include <bitset>
@@ -7,11 +8,13 @@
 #include "CacheUtils.h"
 extern int globalUtilCycle;
 
-Cache::Cache(int coreId, int setIndexBits, int associativity, int blockOffsetBits, Bus* bus)
+Cache::Cache(int coreId, int setIndexBits, int associativity, int blockOffsetBits, Bus* bus,
+             ReplacementPolicy policy)
     : coreId(coreId),
       associativity(associativity),
       blockOffsetBits(blockOffsetBits),
       setIndexBits(setIndexBits),
+      replacementPolicy(policy),
       bus(bus),
       isBlocked(false),
       blockedCycles(0)
@@ -20,10 +23,17 @@ Cache::Cache(int coreId, int setIndexBits, int associativity, int blockOffsetBit
     numSets = 1 << setIndexBits;
     blockSize = 1 << blockOffsetBits;
     tagBits = 32 - setIndexBits - blockOffsetBits;
-    
+
     // Initialize cache sets
-    sets.resize(numSets, CacheSet(associativity, blockSize));
-    
+    sets.resize(numSets, CacheSet(associativity, blockSize, policy));
+
+    // One flat data arena for all lines, indexed set x way x blockSize;
+    // each set gets a pointer to its slice
+    lineData.resize(static_cast<size_t>(numSets) * associativity * blockSize, 0);
+    for (int i = 0; i < numSets; i++) {
+        sets[i].setDataArena(lineData.data() + static_cast<size_t>(i) * associativity * blockSize);
+    }
+
     // Register this cache with the bus
     if (bus) {
         bus->registerCache(this, coreId);
@@ -131,18 +141,18 @@ bool Cache::write(unsigned int address, int& cycles) {
                 
                 CacheSet& set = sets[setIndex];
                 int lineIndex = set.findLine(tag);
-                CacheLine& line = set.getLine(lineIndex);
-        
-                
+                CacheState lineState = set.getState(lineIndex);
+
+
                     // Write hit
-                    if (line.getState() == CacheState::SHARED || line.getState() == CacheState::EXCLUSIVE) {
+                    if (lineState == CacheState::SHARED || lineState == CacheState::EXCLUSIVE) {
                         // Need to upgrade to MODIFIED
-                        if (line.getState() == CacheState::SHARED) {
+                        if (lineState == CacheState::SHARED) {
                             // Issue a bus upgrade to inform other caches
                             bus->busOperation(BusOperation::BusUpgr, address, coreId, dummy, busCycles);
                             cycles += busCycles;
                         }
-                        line.setState(CacheState::MODIFIED);
+                        set.setState(lineIndex, CacheState::MODIFIED);
                     }
                     
                     // If already MODIFIED, no need to do anything
@@ -185,6 +195,7 @@ bool Cache::write(unsigned int address, int& cycles) {
 }
 
 bool Cache::lookupAndUpdate(unsigned int address, bool isWrite, int& cycles) {
+    PROFILE_SCOPE(PHASE_CACHE_LOOKUP);
     unsigned int tag = getTag(address);
     unsigned int setIndex = getSetIndex(address);
     int busCycles = 0;
@@ -214,32 +225,30 @@ void Cache::allocateLine(unsigned int address, bool isWrite, int& cycles, bool b
     // Check if we need to evict a line
     if (set.isFull()) {
         int victimIndex = set.getLRUIndex();
-        CacheLine& victimLine = set.getLine(victimIndex);
-        
+
         // Evict the victim line if necessary
-        if (victimLine.isValid()) {
+        if (set.isValidWay(victimIndex)) {
             // Construct the address from tag, set index, and offset 0
-            unsigned int victimAddress = (victimLine.getTag() << (setIndexBits + blockOffsetBits)) | 
+            unsigned int victimAddress = (set.getTag(victimIndex) << (setIndexBits + blockOffsetBits)) |
                                         (setIndex << blockOffsetBits);
-            evictLine(victimLine, victimAddress, cycles);
+            evictLine(set, victimIndex, victimAddress, cycles);
             stats.incrementEvictions();
         }
     }
-   
-    
+
+
     // Allocate a new line
     int lineIndex = set.allocateLine(tag);
-    CacheLine& line = set.getLine(lineIndex);
-    
+
     // Set the appropriate state based on the operation
     if (isWrite) {
-        line.setState(CacheState::MODIFIED);
+        set.setState(lineIndex, CacheState::MODIFIED);
     } else {
         // For a read, the state depends on whether other caches have the data
         // This was determined during the bus operation
         // If no other cache has it, it's EXCLUSIVE, otherwise SHARED
-        bool otherCachesHaveData = busresponse; 
-        line.setState(otherCachesHaveData ? CacheState::SHARED : CacheState::EXCLUSIVE);
+        bool otherCachesHaveData = busresponse;
+        set.setState(lineIndex, otherCachesHaveData ? CacheState::SHARED : CacheState::EXCLUSIVE);
     }
     
     // Unblock the cache
@@ -247,22 +256,23 @@ void Cache::allocateLine(unsigned int address, bool isWrite, int& cycles, bool b
 }
 
 // Modified to take the line's address
-void Cache::evictLine(CacheLine& line, unsigned int address, int& cycles) {
-    if (line.getState() == CacheState::MODIFIED) {
+void Cache::evictLine(CacheSet& set, int lineIndex, unsigned int address, int& cycles) {
+    CacheState lineState = set.getState(lineIndex);
+    if (lineState == CacheState::MODIFIED) {
         cycles += 100;
-        stats.incrementWritebacks();  
-    } 
-    else if (line.getState() == CacheState::SHARED) {
+        stats.incrementWritebacks();
+    }
+    else if (lineState == CacheState::SHARED) {
         // Check if we're the last cache with this line in SHARED state
         int sharedCacheCount = 0;
         int lastSharedCacheId = -1;
-        
+
         for (Cache* cache : caches) {
             if (cache && cache->coreId != coreId) {
-                int lineIndex = cache->getLineIndex(address);
-                if (lineIndex != -1) {
-                    CacheLine& otherLine = cache->sets[getSetIndex(address)].getLine(lineIndex);
-                    if (otherLine.isValid() && otherLine.getState() == CacheState::SHARED) {
+                int otherIndex = cache->getLineIndex(address);
+                if (otherIndex != -1) {
+                    CacheSet& otherSet = cache->sets[getSetIndex(address)];
+                    if (otherSet.getState(otherIndex) == CacheState::SHARED) {
                         sharedCacheCount++;
                         lastSharedCacheId = cache->coreId;
                     }
@@ -273,16 +283,15 @@ void Cache::evictLine(CacheLine& line, unsigned int address, int& cycles) {
         // If only one other cache has it in SHARED state, promote it to EXCLUSIVE
         if (sharedCacheCount == 1 && lastSharedCacheId != -1) {
             Cache* lastCache = caches[lastSharedCacheId];
-            int lineIndex = lastCache->getLineIndex(address);
-            if (lineIndex != -1) {
-                CacheLine& otherLine = lastCache->sets[getSetIndex(address)].getLine(lineIndex);
-                otherLine.setState(CacheState::EXCLUSIVE);
+            int otherIndex = lastCache->getLineIndex(address);
+            if (otherIndex != -1) {
+                lastCache->sets[getSetIndex(address)].setState(otherIndex, CacheState::EXCLUSIVE);
             }
         }
     }
-    
+
     // Invalidate the line
-    line.setState(CacheState::INVALID);  
+    set.setState(lineIndex, CacheState::INVALID);
 }
 
 bool Cache::snoop(BusOperation op, unsigned int address, int sourceId, bool& providedData, int& cycles) {
@@ -302,8 +311,7 @@ bool Cache::snoop(BusOperation op, unsigned int address, int sourceId, bool& pro
         return true;
     }
     
-    CacheLine& line = set.getLine(lineIndex);
-    CacheState currentState = line.getState();
+    CacheState currentState = set.getState(lineIndex);
     
     switch (op) {
         case BusOperation::BusRd:
@@ -321,7 +329,7 @@ bool Cache::snoop(BusOperation op, unsigned int address, int sourceId, bool& pro
                 stats.incrementBusTraffic(blockSize);
                 
                 // Change state to SHARED, since now it is no longer exclusive
-                line.setState(CacheState::SHARED);
+                set.setState(lineIndex, CacheState::SHARED);
 
             } else if (currentState == CacheState::EXCLUSIVE) {
                 // We have exclusive access but data is clean
@@ -333,7 +341,7 @@ bool Cache::snoop(BusOperation op, unsigned int address, int sourceId, bool& pro
                 stats.incrementBusTraffic(blockSize);
                 
                 // Change state to SHARED, since now it is no longer exclusive
-                line.setState(CacheState::SHARED);
+                set.setState(lineIndex, CacheState::SHARED);
             } else if (currentState == CacheState::SHARED) {
                 // We already share the data, just return the value
                 providedData = true; // Indicating that data is provided
@@ -360,7 +368,7 @@ bool Cache::snoop(BusOperation op, unsigned int address, int sourceId, bool& pro
                 stats.incrementBusTraffic(blockSize);
                 stats.incrementBusTraffic(blockSize);
                 // Invalidate our copy
-                line.setState(CacheState::INVALID);
+                set.setState(lineIndex, CacheState::INVALID);
                 stats.incrementInvalidations();
             } else if (currentState == CacheState::EXCLUSIVE) {
                 // We have exclusive access but data is clean
@@ -373,7 +381,7 @@ bool Cache::snoop(BusOperation op, unsigned int address, int sourceId, bool& pro
                 stats.incrementBusTraffic(blockSize);
                 
                 // Invalidate our copy
-                line.setState(CacheState::INVALID);
+                set.setState(lineIndex, CacheState::INVALID);
                 stats.incrementInvalidations();
             } else if (currentState == CacheState::SHARED) {
                 // We have shared access, but another processor needs exclusive access
@@ -386,7 +394,7 @@ bool Cache::snoop(BusOperation op, unsigned int address, int sourceId, bool& pro
                 stats.incrementBusTraffic(blockSize);
                 
                 // Invalidate our copy
-                line.setState(CacheState::INVALID);
+                set.setState(lineIndex, CacheState::INVALID);
                 stats.incrementInvalidations();
             }
             break;
@@ -394,7 +402,7 @@ bool Cache::snoop(BusOperation op, unsigned int address, int sourceId, bool& pro
         case BusOperation::BusUpgr:
             if (currentState == CacheState::SHARED) {
                 // Another cache wants to upgrade from SHARED to MODIFIED
-                line.setState(CacheState::INVALID); // Invalidate our copy
+                set.setState(lineIndex, CacheState::INVALID); // Invalidate our copy
                 stats.incrementInvalidations();
             } else if (currentState == CacheState::EXCLUSIVE || currentState == CacheState::MODIFIED) {
                 // This is unexpected in MESI protocol but handle it anyway
@@ -407,7 +415,7 @@ bool Cache::snoop(BusOperation op, unsigned int address, int sourceId, bool& pro
                 stats.incrementBusTraffic(blockSize);
                 
                 // Invalidate our copy
-                line.setState(CacheState::INVALID);
+                set.setState(lineIndex, CacheState::INVALID);
                 stats.incrementInvalidations();
             }
             break;
@@ -478,10 +486,9 @@ void Cache::printState() const {
         std::cout << "  Set " << i << ":" << std::endl;
         
         for (int j = 0; j < associativity; j++) {
-            const CacheLine& line = set.getLine(j);
-            if (line.isValid()) {
-                std::cout << "    Line " << j << ": Tag=0x" << std::hex << line.getTag() 
-                          << ", State=" << stateToString(line.getState()) 
+            if (set.isValidWay(j)) {
+                std::cout << "    Line " << j << ": Tag=0x" << std::hex << set.getTag(j)
+                          << ", State=" << stateToString(set.getState(j))
                           << ", LRU=" << std::dec << set.getLRUValue(j) << std::endl;
             }
         }
@@ -507,7 +514,29 @@ std::string Cache::getCacheLineState(unsigned int address) const {
     if (lineIndex == -1) {
         return "INVALID";
     }
-    
-    const CacheLine& line = set.getLine(lineIndex);
-    return stateToString(line.getState());
-}
\ No newline at end of file
+
+    return stateToString(set.getState(lineIndex));
+}
+bool Cache::saveState(std::FILE* f) const {
+    // Configuration is re-derived at construction time; the checkpoint
+    // holds only the mutable state of every set plus blocking and stats
+    for (const CacheSet& set : sets) {
+        if (!set.saveState(f)) {
+            return false;
+        }
+    }
+    if (std::fwrite(&isBlocked, sizeof(isBlocked), 1, f) != 1) return false;
+    if (std::fwrite(&blockedCycles, sizeof(blockedCycles), 1, f) != 1) return false;
+    return stats.saveState(f);
+}
+
+bool Cache::loadState(std::FILE* f) {
+    for (CacheSet& set : sets) {
+        if (!set.loadState(f)) {
+            return false;
+        }
+    }
+    if (std::fread(&isBlocked, sizeof(isBlocked), 1, f) != 1) return false;
+    if (std::fread(&blockedCycles, sizeof(blockedCycles), 1, f) != 1) return false;
+    return stats.loadState(f);
+}
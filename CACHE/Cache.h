@@ -20,8 +20,10 @@ private:
     int blockOffsetBits;            // Number of bits for block offset (b)
     int setIndexBits;               // Number of bits for set index (s)
     int tagBits;                    // Number of bits for tag
-    
+    ReplacementPolicy replacementPolicy;  // Replacement policy for all sets
+
     std::vector<CacheSet> sets;     // Array of cache sets
+    std::vector<uint8_t> lineData;  // Flat data arena, indexed set x way x blockSize
     Bus* bus;                       // Pointer to the shared bus
     Statistics stats;               // Statistics for this cache
     
@@ -37,7 +39,7 @@ private:
     // Internal cache operations
     bool lookupAndUpdate(unsigned int address, bool isWrite, int& cycles);
     void allocateLine(unsigned int address, bool isWrite, int& cycles,  bool busresponse);
-    void evictLine(CacheLine& line, unsigned int address, int& cycles);
+    void evictLine(CacheSet& set, int lineIndex, unsigned int address, int& cycles);
     
     // MESI protocol state transitions
     void handleBusRead(unsigned int address, bool& providedData, int& cycles);
@@ -49,7 +51,8 @@ private:
     int getLineIndex(unsigned int address) const;
     
 public:
-    Cache(int coreId, int setIndexBits, int associativity, int blockOffsetBits, Bus* bus);
+    Cache(int coreId, int setIndexBits, int associativity, int blockOffsetBits, Bus* bus,
+          ReplacementPolicy policy = ReplacementPolicy::LRU);
     ~Cache();
     
     // Cache operations
@@ -74,7 +77,11 @@ public:
     void printState() const;
     std::string getCacheLineState(unsigned int address) const;
     void setCaches(const std::vector<Cache*>& otherCaches);
-    
+
+    // Checkpoint support
+    bool saveState(std::FILE* f) const;
+    bool loadState(std::FILE* f);
+
     // Friend declaration for Bus to access private members
     friend class Bus;
 };
@@ -2,7 +2,7 @@
 #define CACHELINE_H
 
 #include <cstdint>
-#include <string>  // Add this include for std::string
+#include <string>
 
 // MESI cache coherence protocol states
 enum class CacheState {
@@ -12,58 +12,8 @@ enum class CacheState {
     INVALID     // Line does not contain valid data
 };
 
-class CacheLine {
-private:
-    uint32_t tag;           // Tag bits of the address
-    CacheState state;       // MESI state of the cache line
-    uint8_t* data;          // Actual data stored in the cache line
-    int blockSize;  
-     // Size of the cache line in bytes
+// Per-line storage now lives structure-of-arrays style inside CacheSet
+// (tags, states, LRU counters) with line data in a flat arena owned by
+// Cache; see CacheSet.h. This header keeps the shared MESI state enum.
 
-public:
-    // Constructor and destructor
-    CacheLine(int blockSize = 0);
-    ~CacheLine();
-    
-    // Copy constructor and assignment operator
-    CacheLine(const CacheLine& other);
-    CacheLine& operator=(const CacheLine& other);
-    
-    // Move constructor and assignment operator
-    CacheLine(CacheLine&& other) noexcept;
-    CacheLine& operator=(CacheLine&& other) noexcept;
-    
-    // Basic accessors and mutators
-    uint32_t getTag() const;
-    void setTag(uint32_t tag);
-    
-    CacheState getState() const;
-    void setState(CacheState state);
-    
-    // Data access methods
-    uint8_t* getData();
-    const uint8_t* getData() const;
-    
-    // Utility methods
-    bool isValid() const;
-
-    void invalidate();
-    bool isdirty() const;
-
-    // Setter for dirty bit
-    void setDirty(bool value) {
-  // Set the dirty flag to the given value
-        if (value) {
-            state = CacheState::MODIFIED;  // If dirty is true, set the state to MODIFIED
-        }
-    }
-    
-    // Word-level access (for 4-byte words)
-    uint32_t readWord(int offset) const;
-    void writeWord(int offset, uint32_t value);
-};
-
-// Helper function to convert CacheState enum to string
-std::string stateToString(CacheState state);
-
-#endif // CACHELINE_H
\ No newline at end of file
+#endif // CACHELINE_H
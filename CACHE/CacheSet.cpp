@@ -3,41 +3,98 @@
 #include <stdexcept>
 #include <limits>
 
-CacheSet::CacheSet(int associativity, int blockSize)
+CacheSet::CacheSet(int associativity, int blockSize, ReplacementPolicy policy)
     : associativity(associativity),
-      blockSize(blockSize)
+      blockSize(blockSize),
+      dataBase(nullptr),
+      policy(policy),
+      mruWay(0),
+      lruWay(associativity - 1),
+      randState(0x9E3779B9u)
 {
-    // Initialize cache lines
-    lines.reserve(associativity);
+    // Initialize the per-way arrays; all ways start invalid
+    tags.resize(associativity, 0);
+    states.resize(associativity, CacheState::INVALID);
+
+    // Recency list starts in way order: way 0 is MRU, the last way is LRU
+    lruPrev.resize(associativity);
+    lruNext.resize(associativity);
     for (int i = 0; i < associativity; i++) {
-        lines.emplace_back(blockSize);
+        lruPrev[i] = i - 1;
+        lruNext[i] = (i + 1 < associativity) ? i + 1 : -1;
+    }
+
+    // Tree-PLRU needs a power-of-2 way count; otherwise fall back to LRU
+    if (policy == ReplacementPolicy::PLRU && (associativity & (associativity - 1)) != 0) {
+        this->policy = ReplacementPolicy::LRU;
+    }
+    if (this->policy == ReplacementPolicy::PLRU) {
+        plruBits.resize(associativity - 1, 0);
     }
-    
-    // Initialize LRU counters (higher value = less recently used)
-    lruCounter.resize(associativity, 0);
 }
 
 CacheSet::~CacheSet() {
-    // Vector will clean up the CacheLine objects
+    // The data arena is owned by the Cache
 }
 
-CacheLine& CacheSet::getLine(int index) {
+void CacheSet::setDataArena(uint8_t* base) {
+    dataBase = base;
+}
+
+uint32_t CacheSet::getTag(int index) const {
     if (index < 0 || index >= associativity) {
         throw std::out_of_range("Cache line index out of range");
     }
-    return lines[index];
+    return tags[index];
 }
 
-const CacheLine& CacheSet::getLine(int index) const {
+void CacheSet::setTag(int index, uint32_t tag) {
     if (index < 0 || index >= associativity) {
         throw std::out_of_range("Cache line index out of range");
     }
-    return lines[index];
+    tags[index] = tag;
+}
+
+CacheState CacheSet::getState(int index) const {
+    if (index < 0 || index >= associativity) {
+        throw std::out_of_range("Cache line index out of range");
+    }
+    return states[index];
+}
+
+void CacheSet::setState(int index, CacheState state) {
+    if (index < 0 || index >= associativity) {
+        throw std::out_of_range("Cache line index out of range");
+    }
+    states[index] = state;
+}
+
+bool CacheSet::isValidWay(int index) const {
+    if (index < 0 || index >= associativity) {
+        throw std::out_of_range("Cache line index out of range");
+    }
+    return states[index] != CacheState::INVALID;
+}
+
+uint8_t* CacheSet::getLineData(int index) {
+    if (index < 0 || index >= associativity || !dataBase) {
+        return nullptr;
+    }
+    return dataBase + static_cast<size_t>(index) * blockSize;
+}
+
+const uint8_t* CacheSet::getLineData(int index) const {
+    if (index < 0 || index >= associativity || !dataBase) {
+        return nullptr;
+    }
+    return dataBase + static_cast<size_t>(index) * blockSize;
 }
 
 int CacheSet::findLine(uint32_t tag) const {
+    // Hot loop: tags and states are contiguous, so this walks at most
+    // two small arrays with no pointer chasing
     for (int i = 0; i < associativity; i++) {
-        if (lines[i].isValid() && lines[i].getTag() == tag) {
+        if (states[i] != CacheState::INVALID && tags[i] == tag) {
             return i;
         }
     }
@@ -47,58 +104,126 @@ int CacheSet::findLine(uint32_t tag) const {
 int CacheSet::allocateLine(uint32_t tag) {
     // First, check for an invalid line
     for (int i = 0; i < associativity; i++) {
-        if (!lines[i].isValid()) {
-            lines[i].setTag(tag);
+        if (states[i] == CacheState::INVALID) {
+            tags[i] = tag;
             updateLRU(i);
             return i;
         }
     }
-    
+
     // If all lines are valid, use LRU replacement policy
     int lruIndex = getLRUIndex();
-    lines[lruIndex].setTag(tag);
+    tags[lruIndex] = tag;
     updateLRU(lruIndex);
     return lruIndex;
 }
 
+void CacheSet::touchLRUWay(int way) {
+    // Already the most recently used way
+    if (way == mruWay) {
+        return;
+    }
+
+    // Unlink the way from its current position
+    int prev = lruPrev[way];
+    int next = lruNext[way];
+    if (prev != -1) {
+        lruNext[prev] = next;
+    }
+    if (next != -1) {
+        lruPrev[next] = prev;
+    }
+    if (way == lruWay) {
+        lruWay = prev;
+    }
+
+    // Relink it at the head of the recency list
+    lruPrev[way] = -1;
+    lruNext[way] = mruWay;
+    lruPrev[mruWay] = way;
+    mruWay = way;
+}
+
 void CacheSet::updateLRU(int lineIndex) {
     if (lineIndex < 0 || lineIndex >= associativity) {
         throw std::out_of_range("Cache line index out of range");
     }
-    
-    // Increment all counters
-    for (int i = 0; i < associativity; i++) {
-        lruCounter[i]++;
+
+    switch (policy) {
+        case ReplacementPolicy::LRU:
+            touchLRUWay(lineIndex);
+            break;
+
+        case ReplacementPolicy::PLRU: {
+            // Walk from the root to this way, pointing every node away
+            // from the path just taken
+            int node = 0;
+            int span = associativity;
+            while (span > 1) {
+                span /= 2;
+                int goRight = (lineIndex % (span * 2)) >= span;
+                plruBits[node] = goRight ? 0 : 1;  // Point away from the accessed half
+                node = 2 * node + 1 + goRight;
+            }
+            break;
+        }
+
+        case ReplacementPolicy::RANDOM:
+            // No bookkeeping on access
+            break;
     }
-    
-    // Reset the counter for the accessed line
-    lruCounter[lineIndex] = 0;
 }
 
-int CacheSet::getLRUIndex() const {
-    int maxCounter = -1;
-    int lruIndex = 0;
-    
-    for (int i = 0; i < associativity; i++) {
-        if (lruCounter[i] > maxCounter) {
-            maxCounter = lruCounter[i];
-            lruIndex = i;
+int CacheSet::getLRUIndex() {
+    switch (policy) {
+        case ReplacementPolicy::LRU:
+            return lruWay;
+
+        case ReplacementPolicy::PLRU: {
+            // Follow the tree bits to the pseudo-least-recently-used way
+            int node = 0;
+            int base = 0;
+            int span = associativity;
+            while (span > 1) {
+                span /= 2;
+                int goRight = plruBits[node];
+                base += goRight ? span : 0;
+                node = 2 * node + 1 + goRight;
+            }
+            return base;
         }
+
+        case ReplacementPolicy::RANDOM:
+            // Per-set LCG keeps the choice deterministic across runs
+            randState = randState * 1664525u + 1013904223u;
+            return (randState >> 16) % associativity;
     }
-    
-    return lruIndex;
+    return 0;
 }
 
 int CacheSet::getLRUValue(int lineIndex) const {
     if (lineIndex < 0 || lineIndex >= associativity) {
         throw std::out_of_range("Cache line index out of range");
     }
-    return lruCounter[lineIndex];
+
+    // Debug-only: report the way's distance from the MRU position
+    int distance = 0;
+    for (int way = mruWay; way != -1; way = lruNext[way]) {
+        if (way == lineIndex) {
+            return distance;
+        }
+        distance++;
+    }
+    return distance;
+}
+
+ReplacementPolicy CacheSet::getPolicy() const {
+    return policy;
 }
 
 bool CacheSet::isFull() const {
     for (int i = 0; i < associativity; i++) {
-        if (!lines[i].isValid()) {
+        if (states[i] == CacheState::INVALID) {
             return false;
         }
     }
@@ -117,7 +242,7 @@ void CacheSet::invalidateLine(int lineIndex) {
     if (lineIndex < 0 || lineIndex >= associativity) {
         throw std::out_of_range("Cache line index out of range");
     }
-    lines[lineIndex].invalidate();
+    states[lineIndex] = CacheState::INVALID;
 }
 
 void CacheSet::invalidateTag(uint32_t tag) {
@@ -129,7 +254,7 @@ void CacheSet::invalidateTag(uint32_t tag) {
 
 bool CacheSet::hasLineInState(CacheState state) const {
     for (int i = 0; i < associativity; i++) {
-        if (lines[i].getState() == state) {
+        if (states[i] == state) {
             return true;
         }
     }
@@ -138,7 +263,7 @@ bool CacheSet::hasLineInState(CacheState state) const {
 
 int CacheSet::findLineInState(CacheState state) const {
     for (int i = 0; i < associativity; i++) {
-        if (lines[i].getState() == state) {
+        if (states[i] == state) {
             return i;
         }
     }
@@ -146,9 +271,37 @@ int CacheSet::findLineInState(CacheState state) const {
 }
 
 int CacheSet::findLRULine() const {
-    return getLRUIndex();
+    return lruWay;
 }
 
 void CacheSet::updateLRUCounters(int accessedLineIndex) {
     updateLRU(accessedLineIndex);
-}
\ No newline at end of file
+}
+
+bool CacheSet::saveState(std::FILE* f) const {
+    // Associativity and policy come from the configuration, so only the
+    // mutable arrays and replacement bookkeeping are written
+    if (std::fwrite(tags.data(), sizeof(uint32_t), tags.size(), f) != tags.size()) return false;
+    if (std::fwrite(states.data(), sizeof(CacheState), states.size(), f) != states.size()) return false;
+    if (std::fwrite(lruPrev.data(), sizeof(int), lruPrev.size(), f) != lruPrev.size()) return false;
+    if (std::fwrite(lruNext.data(), sizeof(int), lruNext.size(), f) != lruNext.size()) return false;
+    if (std::fwrite(&mruWay, sizeof(mruWay), 1, f) != 1) return false;
+    if (std::fwrite(&lruWay, sizeof(lruWay), 1, f) != 1) return false;
+    if (!plruBits.empty() &&
+        std::fwrite(plruBits.data(), 1, plruBits.size(), f) != plruBits.size()) return false;
+    if (std::fwrite(&randState, sizeof(randState), 1, f) != 1) return false;
+    return true;
+}
+
+bool CacheSet::loadState(std::FILE* f) {
+    if (std::fread(tags.data(), sizeof(uint32_t), tags.size(), f) != tags.size()) return false;
+    if (std::fread(states.data(), sizeof(CacheState), states.size(), f) != states.size()) return false;
+    if (std::fread(lruPrev.data(), sizeof(int), lruPrev.size(), f) != lruPrev.size()) return false;
+    if (std::fread(lruNext.data(), sizeof(int), lruNext.size(), f) != lruNext.size()) return false;
+    if (std::fread(&mruWay, sizeof(mruWay), 1, f) != 1) return false;
+    if (std::fread(&lruWay, sizeof(lruWay), 1, f) != 1) return false;
+    if (!plruBits.empty() &&
+        std::fread(plruBits.data(), 1, plruBits.size(), f) != plruBits.size()) return false;
+    if (std::fread(&randState, sizeof(randState), 1, f) != 1) return false;
+    return true;
+}
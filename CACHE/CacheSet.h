@@ -2,62 +2,122 @@
 #define CACHESET_H
 
 #include <vector>
+#include <cstdio>
 #include "CacheLine.h"
 
+// Replacement policies selectable with the -r command line flag
+enum class ReplacementPolicy {
+    LRU,        // True LRU via a doubly-linked order list, O(1) per access
+    PLRU,       // Tree pseudo-LRU (falls back to LRU for non-power-of-2 ways)
+    RANDOM      // Random victim, no bookkeeping on access
+};
+
+// Helper function to convert ReplacementPolicy enum to string
+inline const char* replacementPolicyName(ReplacementPolicy policy) {
+    switch (policy) {
+        case ReplacementPolicy::LRU: return "LRU";
+        case ReplacementPolicy::PLRU: return "Tree-PLRU";
+        case ReplacementPolicy::RANDOM: return "Random";
+        default: return "Unknown";
+    }
+}
+
+// A cache set stored structure-of-arrays style: tags, MESI states and LRU
+// counters live in small contiguous arrays so the tag-lookup loop walks
+// sequential memory instead of chasing per-line heap allocations. Line data
+// lives in one flat arena owned by the Cache (indexed set x way); each set
+// just holds a pointer to its slice.
 class CacheSet {
 private:
-    std::vector<CacheLine> lines;       // Cache lines in this set
-    std::vector<int> lruCounter;        // LRU counters for each line
+    std::vector<uint32_t> tags;         // Tag per way
+    std::vector<CacheState> states;     // MESI state per way
     int associativity;                  // Number of lines in the set
     int blockSize;                      // Size of each cache line in bytes
-    
-    // Helper method to find the least recently used line
+    uint8_t* dataBase;                  // This set's slice of the cache-wide data arena
+    ReplacementPolicy policy;           // Replacement policy for this set
+
+    // True-LRU bookkeeping: a doubly-linked recency list over the ways,
+    // so touching a way is O(1) instead of walking every counter
+    std::vector<int> lruPrev;           // Previous way in recency order
+    std::vector<int> lruNext;           // Next way in recency order
+    int mruWay;                         // Most recently used way (list head)
+    int lruWay;                         // Least recently used way (list tail)
+
+    // Tree-PLRU bookkeeping: one bit per internal tree node
+    std::vector<uint8_t> plruBits;
+
+    // Random policy: per-set LCG state so sweeps stay deterministic
+    unsigned int randState;
+
+    // Helper method to find the least recently used line (LRU list tail)
     int findLRULine() const;
-    
+
     // Helper method to update LRU counters
     void updateLRUCounters(int accessedLineIndex);
 
+    // Move a way to the front of the recency list in O(1)
+    void touchLRUWay(int way);
+
 public:
     // Constructor
-    CacheSet(int associativity = 1, int blockSize = 64);
-    
+    CacheSet(int associativity = 1, int blockSize = 64,
+             ReplacementPolicy policy = ReplacementPolicy::LRU);
+
     // Destructor
     ~CacheSet();
-    
-    // Line access methods
-    CacheLine& getLine(int index);
-    const CacheLine& getLine(int index) const;
-    
+
+    // Point this set at its slice of the cache-wide data arena
+    void setDataArena(uint8_t* base);
+
+    // Per-way accessors (replacing the old CacheLine& interface)
+    uint32_t getTag(int index) const;
+    void setTag(int index, uint32_t tag);
+
+    CacheState getState(int index) const;
+    void setState(int index, CacheState state);
+
+    bool isValidWay(int index) const;
+
+    uint8_t* getLineData(int index);
+    const uint8_t* getLineData(int index) const;
+
     // Find a line with the given tag
     // Returns the index if found, -1 otherwise
     int findLine(uint32_t tag) const;
-    
+
     // Allocate a line for a new tag
     // Returns the index of the allocated line
     int allocateLine(uint32_t tag);
-    
-    // LRU management
+
+    // Replacement management (named for the historical LRU-only policy;
+    // updateLRU records an access, getLRUIndex picks the victim way)
     void updateLRU(int lineIndex);
-    int getLRUIndex() const;
+    int getLRUIndex();
     int getLRUValue(int lineIndex) const;
-    
+    ReplacementPolicy getPolicy() const;
+
     // Utility methods
     bool isFull() const;
     int getAssociativity() const;
     int getBlockSize() const;
-    
+
     // Invalidate a specific line
     void invalidateLine(int lineIndex);
-    
+
     // Invalidate all lines with the given tag
     void invalidateTag(uint32_t tag);
-    
+
     // Check if any line in the set is in a specific state
     bool hasLineInState(CacheState state) const;
-    
+
     // Find a line in a specific state
     // Returns the index if found, -1 otherwise
     int findLineInState(CacheState state) const;
+
+    // Checkpoint support: write/read tags, states and replacement
+    // bookkeeping (the data arena is owned and handled by the Cache)
+    bool saveState(std::FILE* f) const;
+    bool loadState(std::FILE* f);
 };
 
-#endif // CACHESET_H
\ No newline at end of file
+#endif // CACHESET_H
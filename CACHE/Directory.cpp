@@ -0,0 +1,137 @@
+#include "Directory.h"
+#include "Cache.h"
+#include <iostream>
+
+Directory::Directory()
+    : messagesSent(0)
+{
+    // Directory state starts empty: no cache holds any block
+}
+
+Directory::~Directory() {
+    // Nothing special to clean up
+}
+
+void Directory::processSnooping(BusTransaction& transaction) {
+    uint32_t blockAddress = transaction.address >> filterBlockOffsetBits;
+
+    // A missing entry means no cache holds the block: nothing to do,
+    // the requester fetches from memory
+    auto it = entries.find(blockAddress);
+    if (it == entries.end()) {
+        return;
+    }
+    DirectoryEntry& entry = it->second;
+
+    uint64_t sourceBit = 1ull << transaction.sourceId;
+    uint64_t others = entry.sharers & ~sourceBit;
+    if (others == 0) {
+        return;
+    }
+
+    switch (transaction.operation) {
+        case BusOperation::BusRd: {
+            // Only one cache needs to be contacted for data: the owner if
+            // the block is dirty, otherwise any sharer. MESI guarantees the
+            // remaining sharers are already in SHARED and need no message.
+            int target = (entry.owner >= 0 && (others & (1ull << entry.owner)))
+                             ? entry.owner
+                             : __builtin_ctzll(others);
+            int snoopCycles = 0;
+            caches[target]->snoop(transaction.operation, transaction.address,
+                                  transaction.sourceId, transaction.dataProvided, snoopCycles);
+            messagesSent++;
+            if (snoopCycles > 0 && transaction.dataProvided) {
+                transaction.cycles += snoopCycles;
+            }
+            break;
+        }
+
+        case BusOperation::BusRdX:
+        case BusOperation::BusUpgr: {
+            // Every sharer gets a point-to-point invalidation
+            uint64_t remaining = others;
+            while (remaining != 0) {
+                int target = __builtin_ctzll(remaining);
+                remaining &= remaining - 1;
+                int snoopCycles = 0;
+                caches[target]->snoop(transaction.operation, transaction.address,
+                                      transaction.sourceId, transaction.dataProvided, snoopCycles);
+                messagesSent++;
+                if (snoopCycles > 0 && transaction.dataProvided) {
+                    transaction.cycles += snoopCycles;
+                }
+            }
+            break;
+        }
+
+        case BusOperation::Flush:
+        case BusOperation::FlushOpt:
+            // Writebacks go straight to memory; no other cache is involved
+            break;
+    }
+}
+
+void Directory::updateSnoopFilter(const BusTransaction& transaction) {
+    // The directory entry is the authoritative sharer record
+    uint32_t blockAddress = transaction.address >> filterBlockOffsetBits;
+    uint64_t sourceBit = 1ull << transaction.sourceId;
+    DirectoryEntry& entry = entries[blockAddress];
+
+    switch (transaction.operation) {
+        case BusOperation::BusRd:
+            // The requester joins the sharers; a dirty owner was downgraded
+            // to SHARED by the data-forwarding message above
+            entry.sharers |= sourceBit;
+            entry.dirty = false;
+            entry.owner = -1;
+            break;
+
+        case BusOperation::BusRdX:
+        case BusOperation::BusUpgr:
+            // The requester is now the sole, dirty owner
+            entry.sharers = sourceBit;
+            entry.owner = transaction.sourceId;
+            entry.dirty = true;
+            break;
+
+        case BusOperation::Flush:
+        case BusOperation::FlushOpt:
+            // Memory is up to date again; the source may keep a clean copy
+            entry.dirty = false;
+            break;
+    }
+}
+
+uint64_t Directory::getMessagesSent() const {
+    return messagesSent;
+}
+
+bool Directory::saveState(std::FILE* f) const {
+    if (!Bus::saveState(f)) return false;
+    uint32_t entryCount = static_cast<uint32_t>(entries.size());
+    if (std::fwrite(&entryCount, sizeof(entryCount), 1, f) != 1) return false;
+    for (const auto& pair : entries) {
+        if (std::fwrite(&pair.first, sizeof(pair.first), 1, f) != 1) return false;
+        if (std::fwrite(&pair.second, sizeof(DirectoryEntry), 1, f) != 1) return false;
+    }
+    if (std::fwrite(&messagesSent, sizeof(messagesSent), 1, f) != 1) return false;
+    return true;
+}
+
+bool Directory::loadState(std::FILE* f) {
+    if (!Bus::loadState(f)) return false;
+    uint32_t entryCount = 0;
+    if (std::fread(&entryCount, sizeof(entryCount), 1, f) != 1) return false;
+    entries.clear();
+    entries.reserve(entryCount);
+    for (uint32_t i = 0; i < entryCount; i++) {
+        uint32_t blockAddress = 0;
+        DirectoryEntry entry;
+        if (std::fread(&blockAddress, sizeof(blockAddress), 1, f) != 1) return false;
+        if (std::fread(&entry, sizeof(DirectoryEntry), 1, f) != 1) return false;
+        entries[blockAddress] = entry;
+    }
+    if (std::fread(&messagesSent, sizeof(messagesSent), 1, f) != 1) return false;
+    return true;
+}
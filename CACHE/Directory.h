@@ -0,0 +1,47 @@
+#ifndef DIRECTORY_H
+#define DIRECTORY_H
+
+#include "Bus.h"
+
+// Directory-based coherence engine. It implements the same BusOperation
+// interface as the snooping Bus (caches are unaware of the difference),
+// but instead of broadcasting it keeps an exact per-block directory entry
+// (sharer list, owner, dirty bit) and sends point-to-point messages only
+// to the caches that must act. This removes the per-transaction cost that
+// grows with core count and supports up to 64 cores via 64-bit sharer
+// bitmaps, versus 32 for the bus snoop filter.
+class Directory : public Bus {
+private:
+    // One directory entry per block that any cache may hold
+    struct DirectoryEntry {
+        uint64_t sharers = 0;   // Bitmap of cores holding the block
+        int owner = -1;         // Core with the M/E copy, -1 if none
+        bool dirty = false;     // True if the owner's copy is modified
+    };
+
+    std::unordered_map<uint32_t, DirectoryEntry> entries;
+
+    // Message accounting (point-to-point, instead of broadcast snoops)
+    uint64_t messagesSent;
+
+protected:
+    // Replace the broadcast fan-out with targeted messages
+    void processSnooping(BusTransaction& transaction) override;
+
+    // Directory entries take the role of the bus snoop filter
+    void updateSnoopFilter(const BusTransaction& transaction) override;
+
+public:
+    Directory();
+    ~Directory() override;
+
+    // Number of point-to-point messages sent so far
+    uint64_t getMessagesSent() const;
+
+    // Checkpoint the directory entries on top of the base bus state;
+    // without these a resumed -d run silently loses every sharer bitmap
+    bool saveState(std::FILE* f) const override;
+    bool loadState(std::FILE* f) override;
+};
+
+#endif // DIRECTORY_H
@@ -1,4 +1,5 @@
 #include "Processor.h"
+#include "TracePrefetcher.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
@@ -15,9 +16,10 @@ Processor::Processor(int coreId, const std::string& traceFilePath)
       traceComplete(false),
       blocked(false)
 {
-    // Open the trace file
-    traceFile.open(traceFilePath);
-    if (!traceFile.is_open()) {
+    // Start the background reader for the trace file; it parses large
+    // buffers of references ahead of the simulation thread
+    prefetcher.reset(new TracePrefetcher(traceFilePath));
+    if (!prefetcher->isOpen()) {
         std::cerr << "Error: Could not open trace file: " << traceFilePath << std::endl;
         traceComplete = true;  // Mark as complete to avoid processing
     }
@@ -29,9 +31,7 @@ Processor::Processor(int coreId, const std::string& traceFilePath)
 }
 
 Processor::~Processor() {
-    if (traceFile.is_open()) {
-        traceFile.close();
-    }
+    // The prefetcher joins its reader thread on destruction
 }
 
 void Processor::setCache(std::shared_ptr<Cache> newCache) {
@@ -39,46 +39,16 @@ void Processor::setCache(std::shared_ptr<Cache> newCache) {
 }
 
 bool Processor::loadNextReference() {
-    if (traceFile.eof() || !traceFile.is_open()) {
-        return false;
-    }
-    
-    std::string line;
-    if (std::getline(traceFile, line)) {
-        std::istringstream iss(line);
-        char opType;
-        std::string addressStr;
-        
-        if (iss >> opType >> addressStr) {
-            // Parse the operation type
-            MemoryOperation op;
-            if (opType == 'R' || opType == 'r') {
-                op = MemoryOperation::READ;
-            } else if (opType == 'W' || opType == 'w') {
-                op = MemoryOperation::WRITE;
-            } else {
-                std::cerr << "Error: Unknown operation type: " << opType << std::endl;
-                return false;
-            }
-            
-            // Parse the address
-            uint32_t address = 0;
-            if (addressStr.substr(0, 2) == "0x") {
-                // Hexadecimal address
-                address = std::stoul(addressStr, nullptr, 16);
-            } else {
-                // Decimal address
-                address = std::stoul(addressStr);
-            }
-            
-            // Create and queue the memory reference
-            pendingReferences.emplace(op, address);
-            return true;
-        }
+    // The prefetcher hands out already-parsed references from memory;
+    // all file I/O happens on its background thread
+    MemoryReference ref(MemoryOperation::READ, 0);
+    if (prefetcher && prefetcher->next(ref)) {
+        pendingReferences.push(ref);
+        return true;
     }
     
-    // If we reach here, we've reached the end of the file
-    if (traceFile.eof() && pendingReferences.empty()) {
+    // The trace is exhausted
+    if (pendingReferences.empty()) {
         traceComplete = true;
     }
     
@@ -198,4 +168,64 @@ void Processor::printStatus() const {
               << (totalCycles > 0 ? static_cast<double>(totalInstructions) / totalCycles : 0.0) << std::endl;
     std::cout << "  Trace Complete: " << (traceComplete ? "Yes" : "No") << std::endl;
     std::cout << "  Blocked: " << (blocked ? "Yes" : "No") << std::endl;
-}
\ No newline at end of file
+}
+bool Processor::saveState(std::FILE* f) {
+    if (std::fwrite(&totalInstructions, sizeof(totalInstructions), 1, f) != 1) return false;
+    if (std::fwrite(&readInstructions, sizeof(readInstructions), 1, f) != 1) return false;
+    if (std::fwrite(&writeInstructions, sizeof(writeInstructions), 1, f) != 1) return false;
+    if (std::fwrite(&totalCycles, sizeof(totalCycles), 1, f) != 1) return false;
+    if (std::fwrite(&idleCycles, sizeof(idleCycles), 1, f) != 1) return false;
+    if (std::fwrite(&traceComplete, sizeof(traceComplete), 1, f) != 1) return false;
+    if (std::fwrite(&blocked, sizeof(blocked), 1, f) != 1) return false;
+
+    // Records consumed from the trace so far (includes those sitting in
+    // the pending queue, which is saved below and skipped on restore)
+    uint64_t consumed = prefetcher ? prefetcher->recordsDelivered() : 0;
+    if (std::fwrite(&consumed, sizeof(consumed), 1, f) != 1) return false;
+
+    // Pending references already parsed out of the file
+    uint32_t pendingCount = static_cast<uint32_t>(pendingReferences.size());
+    if (std::fwrite(&pendingCount, sizeof(pendingCount), 1, f) != 1) return false;
+    std::queue<MemoryReference> pending = pendingReferences;
+    while (!pending.empty()) {
+        const MemoryReference& ref = pending.front();
+        uint8_t op = (ref.operation == MemoryOperation::READ) ? 0 : 1;
+        if (std::fwrite(&op, sizeof(op), 1, f) != 1) return false;
+        if (std::fwrite(&ref.address, sizeof(ref.address), 1, f) != 1) return false;
+        pending.pop();
+    }
+    return true;
+}
+
+bool Processor::loadState(std::FILE* f) {
+    if (std::fread(&totalInstructions, sizeof(totalInstructions), 1, f) != 1) return false;
+    if (std::fread(&readInstructions, sizeof(readInstructions), 1, f) != 1) return false;
+    if (std::fread(&writeInstructions, sizeof(writeInstructions), 1, f) != 1) return false;
+    if (std::fread(&totalCycles, sizeof(totalCycles), 1, f) != 1) return false;
+    if (std::fread(&idleCycles, sizeof(idleCycles), 1, f) != 1) return false;
+    if (std::fread(&traceComplete, sizeof(traceComplete), 1, f) != 1) return false;
+    if (std::fread(&blocked, sizeof(blocked), 1, f) != 1) return false;
+
+    uint64_t consumed = 0;
+    if (std::fread(&consumed, sizeof(consumed), 1, f) != 1) return false;
+    if (prefetcher && prefetcher->isOpen()) {
+        // Restart the background reader and discard what was already consumed
+        if (!prefetcher->restartAndSkip(consumed)) {
+            return false;
+        }
+    }
+
+    uint32_t pendingCount = 0;
+    if (std::fread(&pendingCount, sizeof(pendingCount), 1, f) != 1) return false;
+    while (!pendingReferences.empty()) {
+        pendingReferences.pop();
+    }
+    for (uint32_t i = 0; i < pendingCount; i++) {
+        uint8_t op = 0;
+        uint32_t address = 0;
+        if (std::fread(&op, sizeof(op), 1, f) != 1) return false;
+        if (std::fread(&address, sizeof(address), 1, f) != 1) return false;
+        pendingReferences.emplace(op == 0 ? MemoryOperation::READ : MemoryOperation::WRITE, address);
+    }
+    return true;
+}
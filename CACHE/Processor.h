@@ -5,10 +5,12 @@
 #include <fstream>
 #include <queue>
 #include <memory>
+#include <cstdio>
 #include "Cache.h"
 
-// Forward declaration
+// Forward declarations
 class Cache;
+class TracePrefetcher;
 
 // Enum for memory operation type
 enum class MemoryOperation {
@@ -29,7 +31,7 @@ class Processor {
 private:
     int coreId;                         // ID of this processor core
     std::shared_ptr<Cache> cache;       // L1 cache for this processor
-    std::ifstream traceFile;            // Trace file for this processor
+    std::unique_ptr<TracePrefetcher> prefetcher;  // Background double-buffered trace reader
     std::queue<MemoryReference> pendingReferences; // Queue of memory references to process
     
     // Statistics
@@ -74,6 +76,11 @@ public:
     
     // Print processor status
     void printStatus() const;
+
+    // Checkpoint support: saves counters, the pending-reference queue and
+    // the number of records consumed so a restore can skip and continue
+    bool saveState(std::FILE* f);
+    bool loadState(std::FILE* f);
 };
 
 #endif // PROCESSOR_H
\ No newline at end of file
@@ -0,0 +1,121 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// Built-in hot-path instrumentation for the simulator.
+//
+// Compiled out entirely unless CACHE_PROFILE is defined (build with
+// `make PROFILE=1`); when disabled the PROFILE_SCOPE macro expands to
+// nothing, so the instrumented functions pay zero cost. When enabled,
+// each PROFILE_SCOPE reads the host timestamp counter on entry and exit
+// and accumulates the delta into a per-phase atomic, and an atexit hook
+// prints a per-phase breakdown (calls, TSC cycles, estimated host time).
+//
+// Note that the phases nest: runCycles encloses the lookup and snooping
+// phases, so its total is the whole simulation loop, not exclusive time.
+
+#ifdef CACHE_PROFILE
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace profiler {
+
+enum Phase {
+    PHASE_TRACE_READ,    // TraceReader::getNextReference / fillReferences
+    PHASE_CACHE_LOOKUP,  // Cache::lookupAndUpdate
+    PHASE_BUS_SNOOP,     // Bus::processSnooping
+    PHASE_SIM_CYCLES,    // Simulator::runCycles (encloses the others)
+    PHASE_COUNT
+};
+
+inline const char* phaseName(int phase) {
+    switch (phase) {
+        case PHASE_TRACE_READ:   return "TraceReader (reference parse)";
+        case PHASE_CACHE_LOOKUP: return "Cache::lookupAndUpdate";
+        case PHASE_BUS_SNOOP:    return "Bus::processSnooping";
+        case PHASE_SIM_CYCLES:   return "Simulator::runCycles";
+        default:                 return "?";
+    }
+}
+
+// Atomics because the parallel and prefetcher modes time from several
+// host threads; relaxed is fine, we only ever sum the totals
+inline std::atomic<uint64_t> phaseCycles[PHASE_COUNT];
+inline std::atomic<uint64_t> phaseCalls[PHASE_COUNT];
+
+// Read the host timestamp counter, or 0 where unavailable
+inline uint64_t readTsc() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Estimate the TSC frequency by timing a short sleep against the steady
+// clock; good to a few percent, which is plenty for a breakdown report
+inline double measureTscHz() {
+    auto start = std::chrono::steady_clock::now();
+    uint64_t tscStart = readTsc();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    uint64_t tscEnd = readTsc();
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+    return seconds > 0 ? (tscEnd - tscStart) / seconds : 0;
+}
+
+inline void report() {
+    double tscHz = measureTscHz();
+    std::fprintf(stderr, "\n--- profile (TSC ~%.2f GHz) ---\n", tscHz / 1e9);
+    std::fprintf(stderr, "%-34s %12s %16s %10s\n",
+                 "phase", "calls", "cycles", "est. time");
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        uint64_t calls = phaseCalls[p].load();
+        uint64_t cycles = phaseCycles[p].load();
+        double seconds = tscHz > 0 ? cycles / tscHz : 0;
+        std::fprintf(stderr, "%-34s %12llu %16llu %9.3fs\n",
+                     phaseName(p),
+                     (unsigned long long)calls,
+                     (unsigned long long)cycles,
+                     seconds);
+    }
+}
+
+// Registers the report exactly once per program (inline variable, so all
+// translation units share a single instance)
+struct ReportRegistrar {
+    ReportRegistrar() { std::atexit(report); }
+};
+inline ReportRegistrar reportRegistrar;
+
+// Accumulates the enclosed scope's TSC delta into its phase
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Phase phase) : phase(phase), start(readTsc()) {}
+    ~ScopedTimer() {
+        phaseCycles[phase].fetch_add(readTsc() - start, std::memory_order_relaxed);
+        phaseCalls[phase].fetch_add(1, std::memory_order_relaxed);
+    }
+private:
+    Phase phase;
+    uint64_t start;
+};
+
+} // namespace profiler
+
+#define PROFILE_SCOPE(phase) profiler::ScopedTimer profilerScope_(profiler::phase)
+
+#else
+
+#define PROFILE_SCOPE(phase)
+
+#endif // CACHE_PROFILE
+
+#endif // PROFILER_H
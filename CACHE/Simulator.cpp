@@ -1,4 +1,5 @@
 #include "Simulator.h"
+#include "Profiler.h"
 #include <iostream>
 #include <fstream>
 #include <iomanip>
@@ -6,19 +7,45 @@
 #include <sstream>
 #include <cassert>
 
-Simulator::Simulator(const std::string& tracePrefix, int setIndexBits, int associativity, 
-                     int blockOffsetBits, const std::string& outputFile, int numCores)
+Simulator::Simulator(const std::string& tracePrefix, int setIndexBits, int associativity,
+                     int blockOffsetBits, const std::string& outputFile, int numCores,
+                     ReplacementPolicy policy, bool directoryMode, bool splitBusMode)
     : numCores(numCores),
       setIndexBits(setIndexBits),
       associativity(associativity),
       blockOffsetBits(blockOffsetBits),
       tracePrefix(tracePrefix),
       outputFile(outputFile),
+      replacementPolicy(policy),
+      directoryMode(directoryMode),
+      splitBusMode(splitBusMode),
       currentCycle(0),
-      simulationComplete(false)
+      simulationComplete(false),
+      eventDriven(false),
+      samplingInterval(0),
+      nextSampleCycle(0),
+      sampleCapacity(8192),
+      sampleCount(0),
+      checkpointInterval(0),
+      nextCheckpointCycle(0),
+      contentionAnalysis(false),
+      parallelMode(false),
+      workerEpoch(0),
+      workersDone(0),
+      workersExit(false)
 {
-    // Initialize the bus
-    bus = std::make_shared<Bus>();
+    // No core is sleeping initially
+    wakeupCycle.resize(numCores, 0);
+
+    // Initialize the interconnect: snooping bus by default, the directory
+    // engine for larger core counts, or the split-transaction bus model
+    if (directoryMode) {
+        bus = std::make_shared<Directory>();
+    } else if (splitBusMode) {
+        bus = std::make_shared<SplitBus>();
+    } else {
+        bus = std::make_shared<Bus>();
+    }
     
     // Initialize processors and caches
     processors.resize(numCores);
@@ -33,7 +60,7 @@ Simulator::Simulator(const std::string& tracePrefix, int setIndexBits, int assoc
         processors[i] = std::make_shared<Processor>(i, tracePath.str());
         
         // Create cache
-        caches[i] = std::make_shared<Cache>(i, setIndexBits, associativity, blockOffsetBits, bus.get());
+        caches[i] = std::make_shared<Cache>(i, setIndexBits, associativity, blockOffsetBits, bus.get(), policy);
         
         // Associate cache with processor
         processors[i]->setCache(caches[i]);
@@ -41,6 +68,8 @@ Simulator::Simulator(const std::string& tracePrefix, int setIndexBits, int assoc
 }
 
 Simulator::~Simulator() {
+    // Shut down the parallel engine's worker pool if it was started
+    stopWorkers();
     // Smart pointers will handle cleanup
 }
 
@@ -51,6 +80,7 @@ void Simulator::initialize() {
     
     // Reset statistics
     globalStats.reset();
+    std::fill(wakeupCycle.begin(), wakeupCycle.end(), 0);
     
     for (auto& processor : processors) {
         processor->resetStatistics();
@@ -67,15 +97,161 @@ void Simulator::initialize() {
 void Simulator::runSimulation() {
     // Initialize the simulation
     initialize();
-    
+
     // Run until completion
     runUntilCompletion();
-    
+
     // Collect and log statistics
     collectStatistics();
     logStatistics();
 }
 
+volatile std::sig_atomic_t Simulator::checkpointRequested = 0;
+
+void Simulator::setCheckpointing(const std::string& file, int intervalCycles) {
+    checkpointFile = file;
+    checkpointInterval = intervalCycles;
+    nextCheckpointCycle = intervalCycles;
+}
+
+void Simulator::maybeCheckpoint() {
+    if (checkpointFile.empty()) {
+        return;
+    }
+    bool due = (checkpointInterval > 0 && currentCycle >= nextCheckpointCycle);
+    if (!due && !checkpointRequested) {
+        return;
+    }
+    checkpointRequested = 0;
+    while (checkpointInterval > 0 && nextCheckpointCycle <= currentCycle) {
+        nextCheckpointCycle += checkpointInterval;
+    }
+    saveCheckpoint(checkpointFile);
+}
+
+bool Simulator::saveCheckpoint(const std::string& file) const {
+    // Write to a temp file and rename, so a crash mid-snapshot never
+    // destroys the previous good checkpoint
+    std::string tempFile = file + ".tmp";
+    std::FILE* f = std::fopen(tempFile.c_str(), "wb");
+    if (!f) {
+        std::cerr << "Error: Could not create checkpoint file: " << tempFile << std::endl;
+        return false;
+    }
+
+    bool ok = true;
+
+    // Header: magic, then the configuration for validation on restore.
+    // The coherence mode is part of the configuration: a directory
+    // checkpoint carries directory entries that a snooping-bus run could
+    // neither read nor use, so mixing modes must be rejected up front.
+    const uint32_t magic = 0x324B4843;  // "CHK2" (v2 adds the coherence mode)
+    uint8_t coherenceMode = directoryMode ? 1 : (splitBusMode ? 2 : 0);
+    ok = ok && std::fwrite(&magic, sizeof(magic), 1, f) == 1;
+    ok = ok && std::fwrite(&numCores, sizeof(numCores), 1, f) == 1;
+    ok = ok && std::fwrite(&setIndexBits, sizeof(setIndexBits), 1, f) == 1;
+    ok = ok && std::fwrite(&associativity, sizeof(associativity), 1, f) == 1;
+    ok = ok && std::fwrite(&blockOffsetBits, sizeof(blockOffsetBits), 1, f) == 1;
+    ok = ok && std::fwrite(&replacementPolicy, sizeof(replacementPolicy), 1, f) == 1;
+    ok = ok && std::fwrite(&coherenceMode, sizeof(coherenceMode), 1, f) == 1;
+
+    // Simulation state
+    ok = ok && std::fwrite(&currentCycle, sizeof(currentCycle), 1, f) == 1;
+    ok = ok && std::fwrite(&simulationComplete, sizeof(simulationComplete), 1, f) == 1;
+    ok = ok && std::fwrite(wakeupCycle.data(), sizeof(unsigned int),
+                           wakeupCycle.size(), f) == wakeupCycle.size();
+
+    // Components
+    for (int i = 0; ok && i < numCores; i++) {
+        ok = processors[i]->saveState(f);
+    }
+    for (int i = 0; ok && i < numCores; i++) {
+        ok = caches[i]->saveState(f);
+    }
+    ok = ok && bus->saveState(f);
+
+    std::fclose(f);
+    if (!ok) {
+        std::cerr << "Error: Failed to write checkpoint: " << tempFile << std::endl;
+        std::remove(tempFile.c_str());
+        return false;
+    }
+
+    if (std::rename(tempFile.c_str(), file.c_str()) != 0) {
+        std::cerr << "Error: Could not rename checkpoint into place: " << file << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Simulator::loadCheckpoint(const std::string& file) {
+    std::FILE* f = std::fopen(file.c_str(), "rb");
+    if (!f) {
+        std::cerr << "Error: Could not open checkpoint file: " << file << std::endl;
+        return false;
+    }
+
+    bool ok = true;
+
+    // Validate the header against this simulator's configuration
+    uint32_t magic = 0;
+    int ckCores = 0, ckSets = 0, ckAssoc = 0, ckBlock = 0;
+    ReplacementPolicy ckPolicy = ReplacementPolicy::LRU;
+    uint8_t ckMode = 0;
+    uint8_t coherenceMode = directoryMode ? 1 : (splitBusMode ? 2 : 0);
+    ok = ok && std::fread(&magic, sizeof(magic), 1, f) == 1 && magic == 0x324B4843;
+    ok = ok && std::fread(&ckCores, sizeof(ckCores), 1, f) == 1;
+    ok = ok && std::fread(&ckSets, sizeof(ckSets), 1, f) == 1;
+    ok = ok && std::fread(&ckAssoc, sizeof(ckAssoc), 1, f) == 1;
+    ok = ok && std::fread(&ckBlock, sizeof(ckBlock), 1, f) == 1;
+    ok = ok && std::fread(&ckPolicy, sizeof(ckPolicy), 1, f) == 1;
+    ok = ok && std::fread(&ckMode, sizeof(ckMode), 1, f) == 1;
+    if (ok && (ckCores != numCores || ckSets != setIndexBits ||
+               ckAssoc != associativity || ckBlock != blockOffsetBits ||
+               ckPolicy != replacementPolicy)) {
+        std::cerr << "Error: Checkpoint configuration does not match this run." << std::endl;
+        ok = false;
+    }
+    if (ok && ckMode != coherenceMode) {
+        std::cerr << "Error: Checkpoint coherence mode does not match this run." << std::endl;
+        ok = false;
+    }
+
+    ok = ok && std::fread(&currentCycle, sizeof(currentCycle), 1, f) == 1;
+    ok = ok && std::fread(&simulationComplete, sizeof(simulationComplete), 1, f) == 1;
+    ok = ok && std::fread(wakeupCycle.data(), sizeof(unsigned int),
+                          wakeupCycle.size(), f) == wakeupCycle.size();
+
+    for (int i = 0; ok && i < numCores; i++) {
+        ok = processors[i]->loadState(f);
+    }
+    for (int i = 0; ok && i < numCores; i++) {
+        ok = caches[i]->loadState(f);
+    }
+    ok = ok && bus->loadState(f);
+
+    std::fclose(f);
+    if (!ok) {
+        std::cerr << "Error: Failed to restore checkpoint: " << file << std::endl;
+    }
+    return ok;
+}
+
+bool Simulator::resumeSimulation(const std::string& file) {
+    // Wire up the components as usual, then overwrite their state
+    initialize();
+    if (!loadCheckpoint(file)) {
+        return false;
+    }
+
+    std::cout << "Resumed from checkpoint at cycle " << currentCycle << std::endl;
+
+    runUntilCompletion();
+    collectStatistics();
+    logStatistics();
+    return true;
+}
+
 // Add this to Simulator.cpp
 void Simulator::checkForDeadlock() {
     bool allBlockedOrComplete = true;
@@ -122,7 +298,286 @@ void Simulator::resolveDeadlock() {
 
 }
 
+void Simulator::setContentionAnalysis(bool enabled) {
+    contentionAnalysis = enabled;
+    bus->setContentionTracking(enabled);
+}
+
+void Simulator::dumpPingPong() const {
+    if (!contentionAnalysis || outputFile.empty()) {
+        return;
+    }
+
+    // Collect blocks where write ownership actually moved between cores
+    struct ReportRow {
+        uint32_t blockAddress;
+        uint32_t invalidatingOps;
+        uint32_t transitions;
+        uint64_t cyclesLost;
+        uint32_t coresMask;
+    };
+    std::vector<ReportRow> rows;
+    for (const auto& entry : bus->getContention()) {
+        if (entry.second.transitions > 0) {
+            rows.push_back({entry.first, entry.second.invalidatingOps,
+                            entry.second.transitions, entry.second.cyclesLost,
+                            entry.second.coresMask});
+        }
+    }
+
+    // Worst offenders first: most ownership transfers, then cycles lost
+    std::sort(rows.begin(), rows.end(), [](const ReportRow& a, const ReportRow& b) {
+        if (a.transitions != b.transitions) {
+            return a.transitions > b.transitions;
+        }
+        return a.cyclesLost > b.cyclesLost;
+    });
+
+    std::ofstream report(outputFile + ".pingpong.txt");
+    if (!report.is_open()) {
+        std::cerr << "Error: Could not open ping-pong report file: "
+                  << outputFile << ".pingpong.txt" << std::endl;
+        return;
+    }
+
+    int blockBits = bus->getFilterBlockOffsetBits();
+    report << "Top ping-pong lines (blocks whose write ownership moved between cores):"
+           << std::endl;
+    report << "  rank  block_addr    cores        transfers  inval_ops  est_cycles_lost"
+           << std::endl;
+
+    const size_t TOP_LINES = 20;
+    for (size_t i = 0; i < rows.size() && i < TOP_LINES; i++) {
+        const ReportRow& row = rows[i];
+
+        // Render the writer set as a core list
+        std::ostringstream cores;
+        bool first = true;
+        for (int c = 0; c < numCores && c < 32; c++) {
+            if (row.coresMask & (1u << c)) {
+                if (!first) {
+                    cores << ",";
+                }
+                cores << c;
+                first = false;
+            }
+        }
+
+        report << "  " << std::setw(4) << (i + 1)
+               << "  0x" << std::hex << std::setw(8) << std::setfill('0')
+               << (row.blockAddress << blockBits) << std::dec << std::setfill(' ')
+               << "  " << std::setw(11) << std::left << cores.str() << std::right
+               << "  " << std::setw(9) << row.transitions
+               << "  " << std::setw(9) << row.invalidatingOps
+               << "  " << std::setw(15) << row.cyclesLost << std::endl;
+    }
+
+    if (rows.empty()) {
+        report << "  (no block ever changed write ownership)" << std::endl;
+    }
+}
+
+void Simulator::setParallel(bool enabled) {
+    parallelMode = enabled;
+}
+
+void Simulator::startWorkers() {
+    if (!workers.empty()) {
+        return;
+    }
+    coreNeedsSerial.assign(numCores, 0);
+    workersExit = false;
+    workersDone = 0;
+    for (int i = 0; i < numCores; i++) {
+        workers.emplace_back(&Simulator::workerLoop, this, i);
+    }
+}
+
+void Simulator::stopWorkers() {
+    if (workers.empty()) {
+        return;
+    }
+    workersExit = true;
+    workerEpoch++;  // Release any worker still waiting on the barrier
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers.clear();
+}
+
+void Simulator::workerLoop(int coreIndex) {
+    uint64_t lastEpoch = 0;
+    while (true) {
+        // Spin until the coordinator releases the next cycle; cycles are
+        // far shorter than a sleep/wake round trip, so spinning wins
+        while (workerEpoch.load(std::memory_order_acquire) == lastEpoch) {
+            std::this_thread::yield();
+        }
+        if (workersExit.load(std::memory_order_relaxed)) {
+            return;
+        }
+        lastEpoch = workerEpoch.load(std::memory_order_relaxed);
+
+        auto& processor = processors[coreIndex];
+        if (processor->isTraceComplete()) {
+            // Nothing to do for a finished core
+            coreNeedsSerial[coreIndex] = 0;
+        } else if (processor->isBlocked() && caches[coreIndex]->isBlocking()) {
+            // A blocked core only ticks its own counters; that touches no
+            // shared state, so it is safe to run concurrently
+            processor->executeCycle();
+            coreNeedsSerial[coreIndex] = 0;
+        } else {
+            // This core will issue a reference and may touch the bus or
+            // snoop other caches; defer it to the in-order serial phase
+            coreNeedsSerial[coreIndex] = 1;
+        }
+
+        workersDone.fetch_add(1, std::memory_order_release);
+    }
+}
+
+void Simulator::runCyclesParallel(int numCycles) {
+    startWorkers();
+
+    for (int i = 0; i < numCycles && !simulationComplete; i++) {
+        currentCycle++;
+
+        // Process bus activity
+        bus->processCycle();
+
+        // Parallel phase: every worker ticks its core if it is blocked,
+        // or flags it for the serial phase
+        workersDone.store(0, std::memory_order_relaxed);
+        workerEpoch.fetch_add(1, std::memory_order_release);
+        while (workersDone.load(std::memory_order_acquire) < numCores) {
+            std::this_thread::yield();
+        }
+
+        // Serial phase: cores that issue references run in core-id order,
+        // exactly as the sequential engine would
+        for (int c = 0; c < numCores; c++) {
+            if (coreNeedsSerial[c]) {
+                processors[c]->executeCycle();
+            }
+        }
+
+        // Check if simulation is complete
+        simulationComplete = allProcessorsComplete();
+
+        // Take an interval sample if one is due
+        if (samplingInterval > 0 && currentCycle >= nextSampleCycle) {
+            recordSample();
+            nextSampleCycle += samplingInterval;
+        }
+
+        // Take a checkpoint if one is due or was requested by signal
+        maybeCheckpoint();
+
+        // Check for potential deadlock
+        checkForDeadlock();
+
+        // Check cycle limit
+        if (currentCycle > 2147483647) {
+            simulationComplete = true;
+        }
+    }
+}
+
+void Simulator::setEventDriven(bool enabled) {
+    eventDriven = enabled;
+}
+
+void Simulator::setSamplingInterval(int cycles) {
+    samplingInterval = cycles;
+    nextSampleCycle = cycles;
+    sampleCount = 0;
+    if (cycles > 0) {
+        // Preallocate the whole ring up front so recording never allocates
+        sampleBuffer.assign(sampleCapacity * sampleRowSize(), 0);
+    } else {
+        sampleBuffer.clear();
+    }
+}
+
+void Simulator::recordSample() {
+    // Cumulative counters; deltas are computed at dump time
+    uint64_t misses = 0;
+    uint64_t invalidations = 0;
+    uint64_t busTraffic = 0;
+    for (const auto& cache : caches) {
+        const Statistics& cacheStats = cache->getStatistics();
+        misses += cacheStats.getMisses();
+        invalidations += cacheStats.getInvalidations();
+        busTraffic += cacheStats.getBusTraffic();
+    }
+    const Statistics& busStats = bus->getStatistics();
+    invalidations += busStats.getInvalidations();
+    busTraffic += busStats.getBusTraffic();
+
+    uint64_t* row = sampleBuffer.data() + (sampleCount % sampleCapacity) * sampleRowSize();
+    row[0] = static_cast<uint64_t>(currentCycle);
+    row[1] = misses;
+    row[2] = invalidations;
+    row[3] = busTraffic;
+    for (int i = 0; i < numCores; i++) {
+        row[4 + i] = static_cast<uint64_t>(processors[i]->getIdleCycles());
+    }
+    sampleCount++;
+}
+
+void Simulator::dumpSamples() const {
+    if (samplingInterval <= 0 || sampleCount == 0 || outputFile.empty()) {
+        return;
+    }
+
+    std::ofstream csv(outputFile + ".timeseries.csv");
+    if (!csv.is_open()) {
+        std::cerr << "Error: Could not open time-series output file: "
+                  << outputFile << ".timeseries.csv" << std::endl;
+        return;
+    }
+
+    csv << "cycle,misses,invalidations,bus_traffic_bytes";
+    for (int i = 0; i < numCores; i++) {
+        csv << ",idle_cycles_core" << i;
+    }
+    csv << "\n";
+
+    // If the ring wrapped, only the most recent sampleCapacity rows remain
+    size_t firstRow = (sampleCount > sampleCapacity) ? sampleCount - sampleCapacity : 0;
+    std::vector<uint64_t> previous(sampleRowSize(), 0);
+    bool havePrevious = false;
+    for (size_t s = firstRow; s < sampleCount; s++) {
+        const uint64_t* row = sampleBuffer.data() + (s % sampleCapacity) * sampleRowSize();
+        csv << row[0];
+        for (size_t c = 1; c < sampleRowSize(); c++) {
+            // Emit per-interval deltas between consecutive retained rows
+            uint64_t delta = havePrevious ? row[c] - previous[c] : row[c];
+            csv << "," << delta;
+        }
+        csv << "\n";
+        std::copy(row, row + sampleRowSize(), previous.begin());
+        havePrevious = true;
+    }
+}
+
 void Simulator::runCycles(int numCycles) {
+    PROFILE_SCOPE(PHASE_SIM_CYCLES);
+    // Event-driven mode skips over cycles where every core is sleeping
+    if (eventDriven) {
+        runCyclesEventDriven(numCycles);
+        return;
+    }
+
+    // Parallel mode shards the per-core work across host threads
+    if (parallelMode) {
+        runCyclesParallel(numCycles);
+        return;
+    }
+
     for (int i = 0; i < numCycles && !simulationComplete; i++) {
         // Process one cycle
         currentCycle++;
@@ -139,13 +594,22 @@ void Simulator::runCycles(int numCycles) {
         
         // Check if simulation is complete
         simulationComplete = allProcessorsComplete();
-        
+
+        // Take an interval sample if one is due
+        if (samplingInterval > 0 && currentCycle >= nextSampleCycle) {
+            recordSample();
+            nextSampleCycle += samplingInterval;
+        }
+
+        // Take a checkpoint if one is due or was requested by signal
+        maybeCheckpoint();
+
         // Check for potential deadlock
         checkForDeadlock();
-        
+
         // Check cycle limit
         if (currentCycle > 2147483647) {
-            
+
             simulationComplete = true;
         }
     }
@@ -156,6 +620,96 @@ void Simulator::runCycles(int numCycles) {
 
 
 
+void Simulator::runCyclesEventDriven(int numCycles) {
+    // Each core that stalls on a miss is put to sleep until the cycle its
+    // miss resolves, and the simulator jumps currentCycle straight to the
+    // earliest wakeup instead of spinning through the idle cycles.
+    //
+    // This is a DIFFERENT timing model from the default engine, not a
+    // shortcut through it: there a miss resolves synchronously inside
+    // read()/write() (allocateLine clears the block before returning), so
+    // the stall cycles are accounting only and the core issues its next
+    // reference the very next cycle. Sleeping the core for those cycles
+    // changes the order in which contending cores reach shared blocks, so
+    // on contended traces per-core misses, invalidations and bus traffic
+    // differ from the default engine; the two agree only when cores never
+    // contend. See setEventDriven in Simulator.h.
+    for (int i = 0; i < numCycles && !simulationComplete; i++) {
+        currentCycle++;
+
+        // Process bus activity
+        bus->processCycle();
+
+        // Process each core that is awake at this cycle
+        for (size_t p = 0; p < processors.size(); p++) {
+            auto& processor = processors[p];
+            if (processor->isTraceComplete()) {
+                continue;
+            }
+            if (wakeupCycle[p] > static_cast<unsigned int>(currentCycle)) {
+                continue;  // Core is still sleeping on a miss
+            }
+
+            // The idle-cycle delta tells us how long this reference stalled
+            int idleBefore = processor->getIdleCycles();
+            processor->executeCycle();
+            int stallCycles = processor->getIdleCycles() - idleBefore;
+
+            if (stallCycles > 0) {
+                wakeupCycle[p] = currentCycle + stallCycles;
+            }
+        }
+
+        // Check if simulation is complete
+        simulationComplete = allProcessorsComplete();
+        if (simulationComplete) {
+            break;
+        }
+
+        // Find the earliest cycle at which any core can run again
+        unsigned int nextWakeup = 0;
+        bool anyRunnable = false;
+        for (size_t p = 0; p < processors.size(); p++) {
+            if (processors[p]->isTraceComplete()) {
+                continue;
+            }
+            if (wakeupCycle[p] <= static_cast<unsigned int>(currentCycle + 1)) {
+                anyRunnable = true;
+                break;
+            }
+            if (nextWakeup == 0 || wakeupCycle[p] < nextWakeup) {
+                nextWakeup = wakeupCycle[p];
+            }
+        }
+
+        // If every active core is sleeping, jump to the next wakeup
+        if (!anyRunnable && nextWakeup > static_cast<unsigned int>(currentCycle + 1)) {
+            currentCycle = nextWakeup - 1;
+        }
+
+        // Take an interval sample if one is due (a jump may cross several
+        // interval boundaries; the counters were flat while all cores slept,
+        // so one sample stands in for the skipped ones)
+        if (samplingInterval > 0 && currentCycle >= nextSampleCycle) {
+            recordSample();
+            while (nextSampleCycle <= currentCycle) {
+                nextSampleCycle += samplingInterval;
+            }
+        }
+
+        // Take a checkpoint if one is due or was requested by signal
+        maybeCheckpoint();
+
+        // Check for potential deadlock
+        checkForDeadlock();
+
+        // Check cycle limit
+        if (currentCycle > 2147483647) {
+            simulationComplete = true;
+        }
+    }
+}
+
 bool Simulator::allProcessorsComplete() const {
     for (const auto& processor : processors) {
         if (!processor->isTraceComplete()) {
@@ -256,6 +810,12 @@ void Simulator::logStatistics() const {
     
     // Close the file
     outFile.close();
+
+    // Write the interval-sampling time series next to the main output
+    dumpSamples();
+
+    // Write the ping-pong contention report if analysis was enabled
+    dumpPingPong();
 }
 
 void Simulator::printStatistics() const {
@@ -4,9 +4,15 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <csignal>
+#include <thread>
+#include <atomic>
+#include <cstdio>
 #include "Processor.h"
 #include "Cache.h"
 #include "Bus.h"
+#include "Directory.h"
+#include "SplitBus.h"
 #include "Statistics.h"
 
 class Simulator {
@@ -18,6 +24,9 @@ private:
     int blockOffsetBits;       // Number of block offset bits (b)
     std::string tracePrefix;   // Prefix for trace files
     std::string outputFile;    // Output file for logging
+    ReplacementPolicy replacementPolicy;  // Replacement policy for all caches
+    bool directoryMode;        // Use the directory engine instead of the snooping bus
+    bool splitBusMode;         // Use the split-transaction bus model
     
     // Simulation components
     std::vector<std::shared_ptr<Processor>> processors;
@@ -27,20 +36,69 @@ private:
     // Simulation state
     int currentCycle;
     bool simulationComplete;
-    
+
+    // Event-driven fast-forward mode
+    bool eventDriven;                        // Skip idle cycles when enabled
+    std::vector<unsigned int> wakeupCycle;   // Per-core cycle at which the core is runnable again
+
+    // Interval sampling: every samplingInterval cycles a row of cumulative
+    // counters is written into a preallocated ring buffer (so the hot path
+    // is a compare plus a few array stores, no allocation). Rows hold
+    // cycle, misses, invalidations, bus traffic, then idle cycles per core.
+    int samplingInterval;                    // 0 = sampling off
+    int nextSampleCycle;                     // Cycle at which the next row is taken
+    size_t sampleCapacity;                   // Ring capacity in rows
+    size_t sampleCount;                      // Rows recorded (may exceed capacity)
+    std::vector<uint64_t> sampleBuffer;      // Flat ring buffer, sampleRowSize() per row
+    size_t sampleRowSize() const { return 4 + numCores; }
+    void recordSample();
+    void dumpSamples() const;
+
+    // Parallel engine: one persistent worker thread per core ticks the
+    // blocked cores of a cycle concurrently; cores that will issue a
+    // reference (and may touch the bus) are then run on the coordinating
+    // thread in core-id order, so results stay bit-identical to the
+    // sequential engine. Workers rendezvous on a spin barrier per cycle.
+    bool parallelMode;                       // Off by default
+    std::vector<std::thread> workers;        // One per core, started lazily
+    std::atomic<uint64_t> workerEpoch;       // Incremented to release workers
+    std::atomic<int> workersDone;            // Workers finished this epoch
+    std::atomic<bool> workersExit;           // Set to shut the pool down
+    std::vector<uint8_t> coreNeedsSerial;    // Cores that must run in order
+    void startWorkers();
+    void stopWorkers();
+    void workerLoop(int coreIndex);
+    void runCyclesParallel(int numCycles);
+
+    // Ping-pong contention analysis (opt-in): the bus tracks per-block
+    // ownership transfers and a report of the worst lines is written as
+    // <outputFile>.pingpong.txt when statistics are logged
+    bool contentionAnalysis;
+    void dumpPingPong() const;
+
+    // Checkpointing: snapshots are taken every checkpointInterval cycles
+    // (and whenever checkpointRequested is set, e.g. from a signal handler)
+    std::string checkpointFile;              // Empty = checkpointing off
+    int checkpointInterval;                  // Cycles between automatic snapshots
+    int nextCheckpointCycle;                 // Cycle at which the next snapshot is due
+    void maybeCheckpoint();
+
     // Statistics
     Statistics globalStats;
-    
+
     // Helper methods
     void initializeComponents();
     bool allProcessorsComplete() const;
     void collectStatistics();
     void logStatistics() const;
-    
+    void runCyclesEventDriven(int numCycles);
+
 public:
     // Constructor and destructor
-    Simulator(const std::string& tracePrefix, int setIndexBits, int associativity, 
-              int blockOffsetBits, const std::string& outputFile, int numCores = 4);
+    Simulator(const std::string& tracePrefix, int setIndexBits, int associativity,
+              int blockOffsetBits, const std::string& outputFile, int numCores = 4,
+              ReplacementPolicy policy = ReplacementPolicy::LRU,
+              bool directoryMode = false, bool splitBusMode = false);
     ~Simulator();
     
     // Simulation control
@@ -49,6 +107,39 @@ public:
     void runCycles(int numCycles);
     void runUntilCompletion();
     
+    // Enable or disable event-driven fast-forwarding (off by default).
+    // This is an approximate timing model, not an accelerator for the
+    // default engine: a core that misses sleeps until its miss latency
+    // elapses, whereas the default engine lets it issue again the next
+    // cycle (the stall is accounting only). Under contention the
+    // reference interleaving — and so per-core misses, invalidations
+    // and traffic — differs from the default engine. For a speedup with
+    // bit-identical results use the parallel engine (-P) instead.
+    void setEventDriven(bool enabled);
+
+    // Enable the parallel execution engine (off by default); results are
+    // bit-identical to the sequential engine
+    void setParallel(bool enabled);
+
+    // Enable interval sampling every N cycles (0 disables it); snapshots
+    // are dumped as <outputFile>.timeseries.csv when statistics are logged
+    void setSamplingInterval(int cycles);
+
+    // Enable per-block ping-pong tracking and its report (off by default)
+    void setContentionAnalysis(bool enabled);
+
+    // Checkpoint/restore
+    void setCheckpointing(const std::string& file, int intervalCycles);
+    bool saveCheckpoint(const std::string& file) const;
+    bool loadCheckpoint(const std::string& file);
+
+    // Like runSimulation, but restores state from a checkpoint first;
+    // returns false (and runs nothing) if the checkpoint cannot be loaded
+    bool resumeSimulation(const std::string& file);
+
+    // Set from a signal handler to force a snapshot at the next cycle
+    static volatile std::sig_atomic_t checkpointRequested;
+
     // Simulation status
     bool isComplete() const;
     int getCurrentCycle() const;
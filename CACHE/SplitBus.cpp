@@ -0,0 +1,113 @@
+#include "SplitBus.h"
+#include "Cache.h"
+#include <iostream>
+
+SplitBus::SplitBus()
+    : slots(MAX_IN_FLIGHT),
+      slotHead(0),
+      slotCount(0),
+      addrPhaseRemaining(0),
+      totalTransactions(0),
+      addrWaitCycles(0),
+      slotRecycles(0),
+      peakInFlight(0)
+{
+    // The slot ring is allocated once here and reused forever
+}
+
+SplitBus::~SplitBus() {
+    // Nothing special to clean up
+}
+
+void SplitBus::acquireSlot(const BusTransaction& transaction, int dataCycles) {
+    // If every slot is occupied, recycle the oldest phase; it has already
+    // been fully charged to its requester, so only a counter records that
+    // the pool was saturated
+    if (slotCount == MAX_IN_FLIGHT) {
+        slotHead = (slotHead + 1) % MAX_IN_FLIGHT;
+        slotCount--;
+        slotRecycles++;
+    }
+
+    int tail = (slotHead + slotCount) % MAX_IN_FLIGHT;
+    slots[tail].transaction = transaction;
+    slots[tail].remainingCycles = dataCycles;
+    slotCount++;
+
+    if (slotCount > peakInFlight) {
+        peakInFlight = slotCount;
+    }
+}
+
+bool SplitBus::busOperation(BusOperation operation, uint32_t address, int sourceId,
+                            bool& dataProvided, int& cycles) {
+    BusTransaction transaction(operation, address, sourceId);
+    totalTransactions++;
+
+    // Wait for the address lines if an earlier transaction this cycle is
+    // still holding them; this is the only serialization point. The
+    // occupancy is cleared every processCycle, so contention is between
+    // transactions issued in the same simulated cycle.
+    int addrWait = addrPhaseRemaining;
+    addrWaitCycles += addrWait;
+    addrPhaseRemaining += ADDRESS_PHASE_CYCLES;
+
+    // Coherence actions and latency are identical to the blocking bus
+    int dataCycles = executeTransaction(transaction, dataProvided);
+
+    // The data phase occupies a pooled slot and overlaps with other
+    // cores' data phases instead of holding the bus
+    acquireSlot(transaction, dataCycles);
+
+    cycles = addrWait + ADDRESS_PHASE_CYCLES + dataCycles;
+    return true;
+}
+
+void SplitBus::processCycle() {
+    // A new cycle frees the address lines; every phase issued last cycle
+    // has already been charged to its requester
+    addrPhaseRemaining = 0;
+
+    // Advance all in-flight data phases and retire finished ones from the
+    // head of the ring (phases complete in issue order)
+    for (int i = 0; i < slotCount; i++) {
+        DataPhase& phase = slots[(slotHead + i) % MAX_IN_FLIGHT];
+        if (phase.remainingCycles > 0) {
+            phase.remainingCycles--;
+        }
+    }
+    while (slotCount > 0 && slots[slotHead].remainingCycles == 0) {
+        slotHead = (slotHead + 1) % MAX_IN_FLIGHT;
+        slotCount--;
+    }
+}
+
+bool SplitBus::saveState(std::FILE* f) const {
+    if (!Bus::saveState(f)) return false;
+    if (std::fwrite(&slotHead, sizeof(slotHead), 1, f) != 1) return false;
+    if (std::fwrite(&slotCount, sizeof(slotCount), 1, f) != 1) return false;
+    if (std::fwrite(&addrPhaseRemaining, sizeof(addrPhaseRemaining), 1, f) != 1) return false;
+    if (std::fwrite(&totalTransactions, sizeof(totalTransactions), 1, f) != 1) return false;
+    if (std::fwrite(&addrWaitCycles, sizeof(addrWaitCycles), 1, f) != 1) return false;
+    if (std::fwrite(&slotRecycles, sizeof(slotRecycles), 1, f) != 1) return false;
+    if (std::fwrite(&peakInFlight, sizeof(peakInFlight), 1, f) != 1) return false;
+    for (int i = 0; i < MAX_IN_FLIGHT; i++) {
+        if (std::fwrite(&slots[i], sizeof(DataPhase), 1, f) != 1) return false;
+    }
+    return true;
+}
+
+bool SplitBus::loadState(std::FILE* f) {
+    if (!Bus::loadState(f)) return false;
+    if (std::fread(&slotHead, sizeof(slotHead), 1, f) != 1) return false;
+    if (std::fread(&slotCount, sizeof(slotCount), 1, f) != 1) return false;
+    if (std::fread(&addrPhaseRemaining, sizeof(addrPhaseRemaining), 1, f) != 1) return false;
+    if (std::fread(&totalTransactions, sizeof(totalTransactions), 1, f) != 1) return false;
+    if (std::fread(&addrWaitCycles, sizeof(addrWaitCycles), 1, f) != 1) return false;
+    if (std::fread(&slotRecycles, sizeof(slotRecycles), 1, f) != 1) return false;
+    if (std::fread(&peakInFlight, sizeof(peakInFlight), 1, f) != 1) return false;
+    for (int i = 0; i < MAX_IN_FLIGHT; i++) {
+        if (std::fread(&slots[i], sizeof(DataPhase), 1, f) != 1) return false;
+    }
+    return true;
+}
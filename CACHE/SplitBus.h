@@ -0,0 +1,75 @@
+#ifndef SPLITBUS_H
+#define SPLITBUS_H
+
+#include "Bus.h"
+
+// Split-transaction bus. The blocking Bus holds the whole interconnect for
+// the full duration of every transaction, so a 100-cycle memory fetch from
+// one core stalls everyone. Here a transaction is split into a short
+// address phase, which is the only part that is serialized, and a data
+// phase that proceeds in one of a fixed pool of in-flight slots, so
+// independent misses from different cores overlap. The requester pays its
+// own latency plus any wait for the address phase, but never for another
+// core's data phase.
+//
+// In-flight data phases live in a fixed-capacity ring buffer reused for
+// the life of the bus, so the hot path never touches the allocator (the
+// base class's std::queue allocates on every push).
+class SplitBus : public Bus {
+private:
+    // Cycles the address phase occupies the shared address lines
+    static const int ADDRESS_PHASE_CYCLES = 2;
+
+    // Maximum data phases in flight at once; an arriving transaction
+    // waits for the oldest slot if all are occupied
+    static const int MAX_IN_FLIGHT = 16;
+
+    // One in-flight data phase. Slots form a ring: head is the oldest
+    // outstanding phase, count is the number occupied.
+    struct DataPhase {
+        BusTransaction transaction;
+        int remainingCycles;
+
+        DataPhase() : transaction(BusOperation::BusRd, 0, 0), remainingCycles(0) {}
+    };
+
+    std::vector<DataPhase> slots;    // Fixed ring of MAX_IN_FLIGHT slots
+    int slotHead;                    // Index of the oldest in-flight phase
+    int slotCount;                   // Occupied slots
+
+    // Address-line occupancy within the current simulated cycle; cleared
+    // by processCycle, so contention is between same-cycle transactions
+    int addrPhaseRemaining;
+
+    // Occupancy statistics
+    uint64_t totalTransactions;      // Transactions issued through this bus
+    uint64_t addrWaitCycles;         // Cycles spent waiting for the address phase
+    uint64_t slotRecycles;           // Times the slot pool was saturated
+    int peakInFlight;                // Most data phases ever in flight at once
+
+protected:
+    // Reserve a data-phase slot, recycling the oldest one if the pool is full
+    void acquireSlot(const BusTransaction& transaction, int dataCycles);
+
+public:
+    SplitBus();
+    ~SplitBus() override;
+
+    // Address phase is serialized; the data phase overlaps with others
+    bool busOperation(BusOperation operation, uint32_t address, int sourceId,
+                      bool& dataProvided, int& cycles) override;
+
+    // Advance the address phase and retire finished data phases
+    void processCycle() override;
+
+    // Checkpoint support (base state plus the slot ring)
+    bool saveState(std::FILE* f) const override;
+    bool loadState(std::FILE* f) override;
+
+    // Occupancy statistics
+    uint64_t getAddrWaitCycles() const { return addrWaitCycles; }
+    uint64_t getSlotRecycles() const { return slotRecycles; }
+    int getPeakInFlight() const { return peakInFlight; }
+};
+
+#endif // SPLITBUS_H
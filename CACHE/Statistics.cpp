@@ -266,4 +266,14 @@ std::string Statistics::toString() const
 void Statistics::print() const
 {
     std::cout << toString();
-}
\ No newline at end of file
+}
+bool Statistics::saveState(std::FILE* f) const
+{
+    // All members are plain counters; write the object as one blob
+    return std::fwrite(this, sizeof(Statistics), 1, f) == 1;
+}
+
+bool Statistics::loadState(std::FILE* f)
+{
+    return std::fread(this, sizeof(Statistics), 1, f) == 1;
+}
@@ -2,6 +2,7 @@
 #define STATISTICS_H
 
 #include <cstdint>
+#include <cstdio>
 #include <string>
 
 class Statistics {
@@ -83,6 +84,11 @@ void incrementWrites(uint64_t count = 1);
     // Utility methods
     std::string toString() const;
     void print() const;
+
+    // Checkpoint support: the class is a plain bag of counters, so it is
+    // written and read as one binary blob
+    bool saveState(std::FILE* f) const;
+    bool loadState(std::FILE* f);
 };
 
 #endif // STATISTICS_H
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include "TracePrefetcher.h"
+
+TracePrefetcher::TracePrefetcher(const std::string& traceFilePath)
+    : reader(traceFilePath),
+      frontPos(0),
+      backFilled(false),
+      readerDone(false),
+      stopping(false),
+      delivered(0),
+      opened(false)
+{
+    front.reserve(BUFFER_RECORDS);
+    back.reserve(BUFFER_RECORDS);
+
+    opened = reader.open();
+    if (!opened) {
+        // Leave readerDone set so next() immediately reports exhaustion
+        readerDone = true;
+        return;
+    }
+    readerThread = std::thread(&TracePrefetcher::readerLoop, this);
+}
+
+TracePrefetcher::~TracePrefetcher() {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        stopping = true;
+        bufferTaken.notify_all();
+    }
+    if (readerThread.joinable()) {
+        readerThread.join();
+    }
+}
+
+void TracePrefetcher::readerLoop() {
+    std::vector<MemoryReference> filling;
+    filling.reserve(BUFFER_RECORDS);
+
+    bool exhausted = false;
+    while (!exhausted) {
+        // Decode a full buffer outside the lock; this is the part that
+        // touches the disk and it overlaps with simulation
+        filling.assign(BUFFER_RECORDS, MemoryReference(MemoryOperation::READ, 0));
+        size_t produced = reader.fillReferences(filling.data(), BUFFER_RECORDS);
+        filling.erase(filling.begin() + produced, filling.end());
+        exhausted = produced < BUFFER_RECORDS;
+
+        std::unique_lock<std::mutex> lock(mutex);
+        while (backFilled && !stopping) {
+            bufferTaken.wait(lock);
+        }
+        if (stopping) {
+            return;
+        }
+        back.swap(filling);
+        backFilled = !back.empty();
+        if (exhausted) {
+            readerDone = true;
+        }
+        bufferReady.notify_all();
+    }
+}
+
+bool TracePrefetcher::refillFront() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!backFilled && !readerDone) {
+        bufferReady.wait(lock);
+    }
+    if (!backFilled) {
+        return false;  // Reader finished and nothing is left
+    }
+    front.swap(back);
+    back.clear();
+    backFilled = false;
+    frontPos = 0;
+    bufferTaken.notify_all();
+    return true;
+}
+
+bool TracePrefetcher::next(MemoryReference& reference) {
+    if (frontPos >= front.size()) {
+        if (!refillFront()) {
+            return false;
+        }
+    }
+    reference = front[frontPos++];
+    delivered++;
+    return true;
+}
+
+bool TracePrefetcher::restartAndSkip(uint64_t count) {
+    // Stop the current reader thread
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        stopping = true;
+        bufferTaken.notify_all();
+    }
+    if (readerThread.joinable()) {
+        readerThread.join();
+    }
+
+    // Rewind the underlying reader and restart the pipeline
+    if (!reader.reset()) {
+        return false;
+    }
+    front.clear();
+    back.clear();
+    frontPos = 0;
+    backFilled = false;
+    readerDone = false;
+    stopping = false;
+    delivered = 0;
+    readerThread = std::thread(&TracePrefetcher::readerLoop, this);
+
+    // Discard the records consumed before the checkpoint
+    MemoryReference ref(MemoryOperation::READ, 0);
+    for (uint64_t i = 0; i < count; i++) {
+        if (!next(ref)) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,66 @@
+#ifndef TRACEPREFETCHER_H
+#define TRACEPREFETCHER_H
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include "TraceReader.h"
+
+// Asynchronous double-buffered trace reader. A background thread parses
+// references through TraceReader (text or binary) into a large back
+// buffer while the simulation thread drains the front buffer, so
+// executeCycle only ever pops from memory and never touches the disk.
+// When the front buffer runs dry the two are swapped; the simulation
+// thread only blocks if the reader has not finished the back buffer yet,
+// which on local storage essentially never happens.
+class TracePrefetcher {
+private:
+    // Records per buffer; two of these are in flight at any time
+    static const size_t BUFFER_RECORDS = 65536;
+
+    TraceReader reader;                      // Underlying parser (text or binary)
+
+    std::vector<MemoryReference> front;      // Buffer the consumer drains
+    std::vector<MemoryReference> back;       // Buffer the reader thread fills
+    size_t frontPos;                         // Next unread record in front
+
+    std::thread readerThread;
+    std::mutex mutex;
+    std::condition_variable bufferReady;     // Reader -> consumer: back is full
+    std::condition_variable bufferTaken;     // Consumer -> reader: back was swapped out
+    bool backFilled;                         // Back buffer holds unconsumed records
+    bool readerDone;                         // Reader hit end of trace
+    bool stopping;                           // Destructor asked the reader to exit
+
+    uint64_t delivered;                      // Records handed to the consumer so far
+    bool opened;                             // Whether the trace file opened successfully
+
+    // Body of the background reader thread
+    void readerLoop();
+
+    // Swap the drained front buffer for a filled back buffer; returns
+    // false once the trace is exhausted
+    bool refillFront();
+
+public:
+    explicit TracePrefetcher(const std::string& traceFilePath);
+    ~TracePrefetcher();
+
+    // Pop the next reference; false when the trace is exhausted
+    bool next(MemoryReference& reference);
+
+    // Whether the trace file could be opened at all
+    bool isOpen() const { return opened; }
+
+    // Records handed out so far (used as the checkpoint position)
+    uint64_t recordsDelivered() const { return delivered; }
+
+    // Restart from the beginning and discard the first count records;
+    // used to re-synchronize after a checkpoint restore
+    bool restartAndSkip(uint64_t count);
+};
+
+#endif // TRACEPREFETCHER_H
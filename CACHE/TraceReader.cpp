@@ -1,19 +1,36 @@
 #include "TraceReader.h"
+#include "Profiler.h"
 #include <iostream>
 #include <sstream>
 #include <algorithm>
 #include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 TraceReader::TraceReader(const std::string& filePath)
     : traceFilePath(filePath),
       fileOpen(false),
-      endOfFile(false)
+      endOfFile(false),
+      binaryMode(false),
+      binaryFd(-1),
+      binaryBase(nullptr),
+      binarySize(0),
+      binaryPos(0),
+      compressedMode(false),
+      decodePos(0),
+      textMapMode(false),
+      parseErrors(0)
 {
     // Try to open the file immediately
     open();
-    
-    // Preload some references if the file is open
-    if (fileOpen) {
+
+    // Preload some references if the file is open (stream mode only;
+    // mapped traces are read directly from the mapped region)
+    if (fileOpen && !binaryMode && !compressedMode && !textMapMode) {
         preloadReferences(10);
     }
 }
@@ -27,25 +44,242 @@ bool TraceReader::open() {
     if (fileOpen) {
         close();
     }
-    
+
+    // Binary and compressed traces are memory-mapped instead of streamed
+    if (isBinaryTraceFile(traceFilePath)) {
+        return openBinary();
+    }
+    if (isCompressedTraceFile(traceFilePath)) {
+        if (!openBinary()) {
+            return false;
+        }
+        compressedMode = true;
+        binaryMode = false;
+        decodeBuffer.clear();
+        decodePos = 0;
+        return true;
+    }
+
+    // Text traces are also mapped when possible and scanned in place;
+    // the stream path below only remains as a fallback (e.g. pipes)
+    if (openTextMapped()) {
+        return true;
+    }
+
     // Open the trace file
     traceFile.open(traceFilePath);
     fileOpen = traceFile.is_open();
     endOfFile = false;
-    
+
     if (!fileOpen) {
         std::cerr << "Error: Could not open trace file: " << traceFilePath << std::endl;
     }
-    
+
     return fileOpen;
 }
 
+bool TraceReader::openBinary() {
+    // Open and map the whole file read-only
+    binaryFd = ::open(traceFilePath.c_str(), O_RDONLY);
+    if (binaryFd < 0) {
+        std::cerr << "Error: Could not open trace file: " << traceFilePath << std::endl;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(binaryFd, &st) != 0 || st.st_size < (off_t)BINARY_HEADER_SIZE) {
+        std::cerr << "Error: Invalid binary trace file: " << traceFilePath << std::endl;
+        ::close(binaryFd);
+        binaryFd = -1;
+        return false;
+    }
+
+    binarySize = static_cast<size_t>(st.st_size);
+    void* mapped = mmap(nullptr, binarySize, PROT_READ, MAP_PRIVATE, binaryFd, 0);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "Error: Could not mmap trace file: " << traceFilePath << std::endl;
+        ::close(binaryFd);
+        binaryFd = -1;
+        return false;
+    }
+
+    // The kernel can read ahead aggressively; access is strictly sequential
+    madvise(mapped, binarySize, MADV_SEQUENTIAL);
+
+    binaryBase = static_cast<const uint8_t*>(mapped);
+    binaryPos = BINARY_HEADER_SIZE;  // Skip the magic
+    binaryMode = true;
+    fileOpen = true;
+    endOfFile = false;
+    return true;
+}
+
+bool TraceReader::openTextMapped() {
+    binaryFd = ::open(traceFilePath.c_str(), O_RDONLY);
+    if (binaryFd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(binaryFd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        ::close(binaryFd);
+        binaryFd = -1;
+        return false;
+    }
+
+    binarySize = static_cast<size_t>(st.st_size);
+    if (binarySize == 0) {
+        // An empty trace is a valid (finished) trace; no mapping needed
+        binaryBase = nullptr;
+    } else {
+        void* mapped = mmap(nullptr, binarySize, PROT_READ, MAP_PRIVATE, binaryFd, 0);
+        if (mapped == MAP_FAILED) {
+            ::close(binaryFd);
+            binaryFd = -1;
+            return false;
+        }
+        madvise(mapped, binarySize, MADV_SEQUENTIAL);
+        binaryBase = static_cast<const uint8_t*>(mapped);
+    }
+
+    binaryPos = 0;
+    textMapMode = true;
+    fileOpen = true;
+    endOfFile = false;
+    return true;
+}
+
+// Digit-value table for the text scanner: 0-9/a-f/A-F map to their value,
+// everything else to 0xFF. One unconditional lookup classifies and
+// converts a character at the same time, so the accumulation loop has no
+// per-character branching beyond its termination test.
+static const uint8_t HEX_VALUE[256] = {
+    /* 0x00 */ 0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+    /* 0x10 */ 0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+    /* 0x20 */ 0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+    /* 0x30 */ 0x00,0x01,0x02,0x03,0x04,0x05,0x06,0x07,0x08,0x09,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+    /* 0x40 */ 0xFF,0x0A,0x0B,0x0C,0x0D,0x0E,0x0F,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+    /* 0x50 */ 0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+    /* 0x60 */ 0xFF,0x0A,0x0B,0x0C,0x0D,0x0E,0x0F,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+    /* 0x70 */ 0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+    /* 0x80 */ 0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+    /* 0x90 */ 0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+    /* 0xA0 */ 0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+    /* 0xB0 */ 0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+    /* 0xC0 */ 0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+    /* 0xD0 */ 0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+    /* 0xE0 */ 0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+    /* 0xF0 */ 0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,
+};
+
+bool TraceReader::scanTextRecord(MemoryReference& reference) {
+    const uint8_t* base = binaryBase;
+    size_t pos = binaryPos;
+    const size_t size = binarySize;
+
+    while (pos < size) {
+        // Skip leading whitespace and blank lines
+        while (pos < size && (base[pos] == ' ' || base[pos] == '\t' ||
+                              base[pos] == '\r' || base[pos] == '\n')) {
+            pos++;
+        }
+        if (pos >= size) {
+            break;
+        }
+
+        // Comment lines are skipped whole
+        if (base[pos] == '#') {
+            while (pos < size && base[pos] != '\n') {
+                pos++;
+            }
+            continue;
+        }
+
+        size_t lineStart = pos;
+
+        // Operation letter: OR with 0x20 folds the case
+        uint8_t opChar = base[pos] | 0x20;
+        bool isWrite = (opChar == 'w');
+        bool opValid = isWrite || (opChar == 'r');
+        pos++;
+
+        // Whitespace between the operation and the address
+        while (pos < size && (base[pos] == ' ' || base[pos] == '\t')) {
+            pos++;
+        }
+
+        // Optional 0x/0X prefix selects hex; otherwise decimal
+        uint32_t radix = 10;
+        if (pos + 1 < size && base[pos] == '0' && (base[pos + 1] | 0x20) == 'x') {
+            radix = 16;
+            pos += 2;
+        }
+
+        // Accumulate digits; the lookup table classifies and converts in
+        // one unconditional load per character
+        uint32_t address = 0;
+        size_t digitStart = pos;
+        uint8_t value;
+        while (pos < size && (value = HEX_VALUE[base[pos]]) < radix) {
+            address = address * radix + value;
+            pos++;
+        }
+        bool haveDigits = pos > digitStart;
+
+        // The record must end the line (allowing trailing whitespace)
+        while (pos < size && (base[pos] == ' ' || base[pos] == '\t' || base[pos] == '\r')) {
+            pos++;
+        }
+        bool atLineEnd = (pos >= size) || (base[pos] == '\n');
+
+        if (opValid && haveDigits && atLineEnd) {
+            binaryPos = pos;
+            reference.operation = isWrite ? MemoryOperation::WRITE : MemoryOperation::READ;
+            reference.address = address;
+            return true;
+        }
+
+        // Malformed line: count it, skip to the next line and carry on
+        // (errors are reported through getParseErrors, never thrown)
+        parseErrors++;
+        pos = lineStart;
+        while (pos < size && base[pos] != '\n') {
+            pos++;
+        }
+    }
+
+    binaryPos = pos;
+    endOfFile = true;
+    return false;
+}
+
+void TraceReader::closeBinary() {
+    if (binaryBase) {
+        munmap(const_cast<uint8_t*>(binaryBase), binarySize);
+        binaryBase = nullptr;
+    }
+    if (binaryFd >= 0) {
+        ::close(binaryFd);
+        binaryFd = -1;
+    }
+    binarySize = 0;
+    binaryPos = 0;
+    binaryMode = false;
+}
+
 void TraceReader::close() {
-    if (fileOpen) {
+    if (binaryMode || compressedMode || textMapMode) {
+        closeBinary();
+        compressedMode = false;
+        textMapMode = false;
+        decodeBuffer.clear();
+        decodePos = 0;
+        fileOpen = false;
+    } else if (fileOpen) {
         traceFile.close();
         fileOpen = false;
     }
-    
+
     // Clear the reference queue
     while (!referenceQueue.empty()) {
         referenceQueue.pop();
@@ -57,6 +291,15 @@ bool TraceReader::isOpen() const {
 }
 
 bool TraceReader::isEndOfFile() const {
+    if (binaryMode) {
+        return binaryPos + BINARY_RECORD_SIZE > binarySize;
+    }
+    if (compressedMode) {
+        return decodePos >= decodeBuffer.size() && binaryPos >= binarySize;
+    }
+    if (textMapMode) {
+        return binaryPos >= binarySize;
+    }
     return endOfFile && referenceQueue.empty();
 }
 
@@ -130,6 +373,37 @@ void TraceReader::preloadReferences(int count) {
 }
 
 bool TraceReader::getNextReference(MemoryReference& reference) {
+    PROFILE_SCOPE(PHASE_TRACE_READ);
+    // Binary fast path: read the packed record straight out of the mapping
+    if (binaryMode) {
+        if (binaryPos + BINARY_RECORD_SIZE > binarySize) {
+            endOfFile = true;
+            return false;
+        }
+        const uint8_t* rec = binaryBase + binaryPos;
+        binaryPos += BINARY_RECORD_SIZE;
+
+        reference.operation = (rec[0] == 0) ? MemoryOperation::READ : MemoryOperation::WRITE;
+        reference.address = (uint32_t)rec[1] | ((uint32_t)rec[2] << 8) |
+                            ((uint32_t)rec[3] << 16) | ((uint32_t)rec[4] << 24);
+        return true;
+    }
+
+    // Compressed path: hand out records from the decoded block
+    if (compressedMode) {
+        if (decodePos >= decodeBuffer.size() && !decodeNextBlock()) {
+            endOfFile = true;
+            return false;
+        }
+        reference = decodeBuffer[decodePos++];
+        return true;
+    }
+
+    // Mapped text fast path: scan the record in place
+    if (textMapMode) {
+        return scanTextRecord(reference);
+    }
+
     // If the queue is empty, try to load more references
     if (referenceQueue.empty() && !endOfFile) {
         preloadReferences(10);
@@ -152,6 +426,65 @@ bool TraceReader::getNextReference(MemoryReference& reference) {
     return true;
 }
 
+size_t TraceReader::fillReferences(MemoryReference* out, size_t maxCount) {
+    size_t count = 0;
+
+    // Binary records decode straight out of the mapping
+    if (binaryMode) {
+        PROFILE_SCOPE(PHASE_TRACE_READ);
+        while (count < maxCount && binaryPos + BINARY_RECORD_SIZE <= binarySize) {
+            const uint8_t* rec = binaryBase + binaryPos;
+            binaryPos += BINARY_RECORD_SIZE;
+            out[count].operation = (rec[0] == 0) ? MemoryOperation::READ
+                                                 : MemoryOperation::WRITE;
+            out[count].address = (uint32_t)rec[1] | ((uint32_t)rec[2] << 8) |
+                                 ((uint32_t)rec[3] << 16) | ((uint32_t)rec[4] << 24);
+            count++;
+        }
+        if (binaryPos + BINARY_RECORD_SIZE > binarySize) {
+            endOfFile = true;
+        }
+        return count;
+    }
+
+    // Compressed blocks are decoded wholesale and copied out
+    if (compressedMode) {
+        PROFILE_SCOPE(PHASE_TRACE_READ);
+        while (count < maxCount) {
+            if (decodePos >= decodeBuffer.size() && !decodeNextBlock()) {
+                endOfFile = true;
+                break;
+            }
+            size_t chunk = decodeBuffer.size() - decodePos;
+            if (chunk > maxCount - count) {
+                chunk = maxCount - count;
+            }
+            for (size_t i = 0; i < chunk; i++) {
+                out[count + i] = decodeBuffer[decodePos + i];
+            }
+            decodePos += chunk;
+            count += chunk;
+        }
+        return count;
+    }
+
+    // Mapped text is scanned in place; the stream fallback below is
+    // already timed inside getNextReference itself
+    if (textMapMode) {
+        PROFILE_SCOPE(PHASE_TRACE_READ);
+        while (count < maxCount && scanTextRecord(out[count])) {
+            count++;
+        }
+        return count;
+    }
+
+    // Stream fallback
+    while (count < maxCount && getNextReference(out[count])) {
+        count++;
+    }
+    return count;
+}
+
 int TraceReader::getReferences(std::vector<MemoryReference>& references, int maxCount) {
     int count = 0;
     
@@ -170,6 +503,25 @@ int TraceReader::getReferences(std::vector<MemoryReference>& references, int max
 }
 
 bool TraceReader::reset() {
+    // Mapped traces just rewind to the first record
+    if (binaryMode) {
+        binaryPos = BINARY_HEADER_SIZE;
+        endOfFile = false;
+        return true;
+    }
+    if (compressedMode) {
+        binaryPos = BINARY_HEADER_SIZE;
+        decodeBuffer.clear();
+        decodePos = 0;
+        endOfFile = false;
+        return true;
+    }
+    if (textMapMode) {
+        binaryPos = 0;
+        endOfFile = false;
+        return true;
+    }
+
     // Close and reopen the file
     close();
     return open();
@@ -183,4 +535,187 @@ std::string TraceReader::createTraceFilePath(const std::string& appName, int cor
     std::ostringstream oss;
     oss << appName << "_proc" << coreId << ".trace";
     return oss.str();
-}
\ No newline at end of file
+}
+
+bool TraceReader::decodeNextBlock() {
+    if (binaryPos + COMPRESSED_BLOCK_HEADER_SIZE > binarySize) {
+        return false;
+    }
+
+    // Block header: record count, payload size, base address
+    uint32_t recordCount, payloadBytes, baseAddress;
+    std::memcpy(&recordCount, binaryBase + binaryPos, 4);
+    std::memcpy(&payloadBytes, binaryBase + binaryPos + 4, 4);
+    std::memcpy(&baseAddress, binaryBase + binaryPos + 8, 4);
+    binaryPos += COMPRESSED_BLOCK_HEADER_SIZE;
+
+    if (binaryPos + payloadBytes > binarySize) {
+        std::cerr << "Error: Truncated compressed trace block in: " << traceFilePath << std::endl;
+        binaryPos = binarySize;
+        return false;
+    }
+
+    const uint8_t* p = binaryBase + binaryPos;
+    const uint8_t* end = p + payloadBytes;
+    binaryPos += payloadBytes;
+
+    decodeBuffer.clear();
+    decodeBuffer.reserve(recordCount);
+    decodePos = 0;
+
+    uint32_t address = baseAddress;
+    for (uint32_t i = 0; i < recordCount && p < end; i++) {
+        // LEB128 varint: 7 payload bits per byte, high bit continues
+        uint64_t token = 0;
+        int shift = 0;
+        while (p < end) {
+            uint8_t byte = *p++;
+            token |= (uint64_t)(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                break;
+            }
+            shift += 7;
+        }
+
+        // Low bit is the operation; the rest is the zigzag address delta
+        bool isWrite = (token & 1) != 0;
+        uint32_t zz = (uint32_t)(token >> 1);
+        int32_t delta = (int32_t)((zz >> 1) ^ (~(zz & 1) + 1));
+        address += (uint32_t)delta;
+
+        decodeBuffer.emplace_back(isWrite ? MemoryOperation::WRITE : MemoryOperation::READ,
+                                  address);
+    }
+
+    return !decodeBuffer.empty();
+}
+
+bool TraceReader::isBinaryTraceFile(const std::string& filePath) {
+    // Check the magic bytes at the start of the file
+    FILE* f = fopen(filePath.c_str(), "rb");
+    if (!f) {
+        return false;
+    }
+
+    uint32_t magic = 0;
+    size_t read = fread(&magic, 1, sizeof(magic), f);
+    fclose(f);
+
+    return read == sizeof(magic) && magic == BINARY_MAGIC;
+}
+
+bool TraceReader::isCompressedTraceFile(const std::string& filePath) {
+    FILE* f = fopen(filePath.c_str(), "rb");
+    if (!f) {
+        return false;
+    }
+
+    uint32_t magic = 0;
+    size_t read = fread(&magic, 1, sizeof(magic), f);
+    fclose(f);
+
+    return read == sizeof(magic) && magic == COMPRESSED_MAGIC;
+}
+
+long TraceReader::convertToBinary(const std::string& textPath, const std::string& binaryPath) {
+    // Parse the text trace with the normal reader
+    TraceReader reader(textPath);
+    if (!reader.isOpen()) {
+        return -1;
+    }
+
+    FILE* out = fopen(binaryPath.c_str(), "wb");
+    if (!out) {
+        std::cerr << "Error: Could not create binary trace file: " << binaryPath << std::endl;
+        return -1;
+    }
+
+    // Write the magic header
+    uint32_t magic = BINARY_MAGIC;
+    fwrite(&magic, 1, sizeof(magic), out);
+
+    // Write one packed record per reference
+    long count = 0;
+    MemoryReference reference(MemoryOperation::READ, 0);
+    uint8_t rec[BINARY_RECORD_SIZE];
+    while (reader.getNextReference(reference)) {
+        rec[0] = (reference.operation == MemoryOperation::READ) ? 0 : 1;
+        rec[1] = (uint8_t)(reference.address & 0xFF);
+        rec[2] = (uint8_t)((reference.address >> 8) & 0xFF);
+        rec[3] = (uint8_t)((reference.address >> 16) & 0xFF);
+        rec[4] = (uint8_t)((reference.address >> 24) & 0xFF);
+        fwrite(rec, 1, BINARY_RECORD_SIZE, out);
+        count++;
+    }
+
+    fclose(out);
+    return count;
+}
+long TraceReader::convertToCompressed(const std::string& inputPath, const std::string& outputPath) {
+    TraceReader reader(inputPath);
+    if (!reader.isOpen()) {
+        return -1;
+    }
+
+    FILE* out = fopen(outputPath.c_str(), "wb");
+    if (!out) {
+        std::cerr << "Error: Could not create compressed trace file: " << outputPath << std::endl;
+        return -1;
+    }
+
+    uint32_t magic = COMPRESSED_MAGIC;
+    fwrite(&magic, 1, sizeof(magic), out);
+
+    std::vector<MemoryReference> block;
+    block.reserve(COMPRESSED_BLOCK_RECORDS);
+    std::vector<uint8_t> payload;
+    payload.reserve(COMPRESSED_BLOCK_RECORDS * 2);
+
+    long total = 0;
+    bool more = true;
+    MemoryReference reference(MemoryOperation::READ, 0);
+    while (more) {
+        block.clear();
+        while (block.size() < COMPRESSED_BLOCK_RECORDS &&
+               reader.getNextReference(reference)) {
+            block.push_back(reference);
+        }
+        more = block.size() == COMPRESSED_BLOCK_RECORDS;
+        if (block.empty()) {
+            break;
+        }
+
+        // Deltas are relative to the previous record in this block, with
+        // the block's first address carried in the header, so blocks
+        // decode independently
+        uint32_t baseAddress = block[0].address;
+        uint32_t previous = baseAddress;
+        payload.clear();
+        for (const MemoryReference& ref : block) {
+            int32_t delta = (int32_t)(ref.address - previous);
+            previous = ref.address;
+            uint32_t zz = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+            uint64_t token = ((uint64_t)zz << 1) |
+                             (ref.operation == MemoryOperation::WRITE ? 1 : 0);
+            do {
+                uint8_t byte = token & 0x7F;
+                token >>= 7;
+                if (token != 0) {
+                    byte |= 0x80;
+                }
+                payload.push_back(byte);
+            } while (token != 0);
+        }
+
+        uint32_t recordCount = (uint32_t)block.size();
+        uint32_t payloadBytes = (uint32_t)payload.size();
+        fwrite(&recordCount, 1, sizeof(recordCount), out);
+        fwrite(&payloadBytes, 1, sizeof(payloadBytes), out);
+        fwrite(&baseAddress, 1, sizeof(baseAddress), out);
+        fwrite(payload.data(), 1, payload.size(), out);
+        total += recordCount;
+    }
+
+    fclose(out);
+    return total;
+}
@@ -16,16 +16,47 @@ private:
     std::ifstream traceFile;        // File stream for reading the trace
     bool fileOpen;                  // Flag indicating if file is open
     bool endOfFile;                 // Flag indicating if end of file has been reached
-    
+
+    // Binary trace support (memory-mapped, zero parsing per record)
+    bool binaryMode;                // True if the trace is in packed binary format
+    int binaryFd;                   // File descriptor for the mapped trace
+    const uint8_t* binaryBase;      // Start of the mapped region
+    size_t binarySize;              // Size of the mapped region in bytes
+    size_t binaryPos;               // Current read offset into the mapped region
+
+    // Compressed trace support: the file is mmap'd (fields above) and
+    // decoded one framed block at a time into decodeBuffer
+    bool compressedMode;            // True for the delta/varint container
+    std::vector<MemoryReference> decodeBuffer;  // Records of the current block
+    size_t decodePos;               // Next unread record in decodeBuffer
+
+    // Decode the next framed block into decodeBuffer; false at end of file
+    bool decodeNextBlock();
+
+    // Text fast path: the text file is mmap'd (reusing the fields above)
+    // and scanned in place, instead of getline + istringstream + stoul
+    bool textMapMode;               // True when a text trace is mapped
+    uint64_t parseErrors;           // Malformed lines skipped so far
+
+    // Scan one record out of the mapped text; returns false at end of map
+    bool scanTextRecord(MemoryReference& reference);
+
     // Queue of pre-read memory references
     std::queue<MemoryReference> referenceQueue;
-    
+
     // Helper method to parse a line from the trace file
     bool parseLine(const std::string& line, MemoryReference& reference);
-    
+
     // Helper method to preload some references
     void preloadReferences(int count);
-    
+
+    // Helper methods for the binary format
+    bool openBinary();
+    void closeBinary();
+
+    // Map a text trace for in-place scanning; false if mmap is unavailable
+    bool openTextMapped();
+
 public:
     // Constructor and destructor
     TraceReader(const std::string& filePath);
@@ -44,6 +75,15 @@ public:
     
     // Get multiple references at once
     int getReferences(std::vector<MemoryReference>& references, int maxCount);
+
+    // Bulk fill: decode up to maxCount references into out, returning the
+    // number produced. This is the hot-path API: one call amortizes all
+    // per-record overhead, and parse errors are counted and skipped, never
+    // thrown.
+    size_t fillReferences(MemoryReference* out, size_t maxCount);
+
+    // Malformed text lines skipped so far
+    uint64_t getParseErrors() const { return parseErrors; }
     
     // Reset the reader to the beginning of the file
     bool reset();
@@ -53,6 +93,39 @@ public:
     
     // Static method to create trace file paths for a given application and core
     static std::string createTraceFilePath(const std::string& appName, int coreId);
+
+    // Binary trace format constants
+    // Layout: 4-byte magic "BTR1", then packed 5-byte records
+    // (1 op byte: 0 = read, 1 = write; 4-byte little-endian address)
+    static const uint32_t BINARY_MAGIC = 0x31525442;  // "BTR1"
+    static const size_t BINARY_HEADER_SIZE = 4;
+    static const size_t BINARY_RECORD_SIZE = 5;
+
+    // Compressed trace format constants
+    // Layout: 4-byte magic "BTR2", then independently decodable blocks:
+    // {uint32 recordCount, uint32 payloadBytes, uint32 baseAddress}
+    // followed by payloadBytes of LEB128 varints, one per record, each
+    // encoding (zigzag(addressDelta) << 1) | opBit. Deltas are relative
+    // to the previous record in the same block (baseAddress for the
+    // first), so any block can be decoded without its predecessors --
+    // which also lets multiple threads decode different blocks at once.
+    static const uint32_t COMPRESSED_MAGIC = 0x32525442;  // "BTR2"
+    static const size_t COMPRESSED_BLOCK_RECORDS = 4096;
+    static const size_t COMPRESSED_BLOCK_HEADER_SIZE = 12;
+
+    // Check whether a file is a binary trace (by magic bytes)
+    static bool isBinaryTraceFile(const std::string& filePath);
+
+    // Check whether a file is a compressed trace (by magic bytes)
+    static bool isCompressedTraceFile(const std::string& filePath);
+
+    // Convert a text trace file to the packed binary format
+    // Returns the number of records written, or -1 on failure
+    static long convertToBinary(const std::string& textPath, const std::string& binaryPath);
+
+    // Convert a trace file (any readable format) to the compressed format
+    // Returns the number of records written, or -1 on failure
+    static long convertToCompressed(const std::string& inputPath, const std::string& outputPath);
 };
 
 #endif // TRACEREADER_H
\ No newline at end of file
@@ -0,0 +1,151 @@
+// Microbenchmark harness for the cache hot path.
+//
+// Drives Cache and Bus directly (no Processor, no trace files) with three
+// synthetic reference streams that bracket the simulator's behavior:
+//   hit-heavy   - working set fits in one cache, nearly all hits
+//   miss-heavy  - streaming access, every block is a compulsory miss
+//   ping-pong   - two cores alternately write the same block (invalidations)
+// For each stream it reports references/second and host time per simulated
+// access, both in nanoseconds and in TSC cycles. Run via `make bench`;
+// `make bench-baseline` stores the current numbers so later runs can be
+// diffed against them.
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "Cache.h"
+#include "Bus.h"
+
+// Normally defined in main.cpp; bench is a separate binary
+unsigned int currentGlobalCycle = 0;
+
+// Cache geometry used for every benchmark (matches the default experiments)
+static const int SET_INDEX_BITS = 6;
+static const int ASSOCIATIVITY = 2;
+static const int BLOCK_OFFSET_BITS = 5;
+static const int NUM_CORES = 4;
+
+namespace {
+
+// Read the host timestamp counter, or 0 where unavailable
+uint64_t readTsc() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// A benchmark owns a fresh bus and caches so streams don't pollute each other
+struct BenchRig {
+    std::shared_ptr<Bus> bus;
+    std::vector<std::shared_ptr<Cache>> caches;
+
+    BenchRig() {
+        bus = std::make_shared<Bus>();
+        for (int i = 0; i < NUM_CORES; i++) {
+            caches.push_back(std::make_shared<Cache>(i, SET_INDEX_BITS, ASSOCIATIVITY,
+                                                     BLOCK_OFFSET_BITS, bus.get()));
+        }
+        bus->connectCaches();
+    }
+
+    // Issue one reference and immediately clear the miss-induced block, so
+    // the benchmark measures the access path rather than stall bookkeeping
+    void access(int core, bool isWrite, unsigned int address) {
+        int cycles = 0;
+        if (isWrite) {
+            caches[core]->write(address, cycles);
+        } else {
+            caches[core]->read(address, cycles);
+        }
+        if (caches[core]->isBlocking()) {
+            caches[core]->unblock();
+        }
+    }
+};
+
+// One synthetic reference: core, read/write, address
+struct BenchRef {
+    int core;
+    bool isWrite;
+    unsigned int address;
+};
+
+void runStream(const std::string& name, const std::vector<BenchRef>& refs) {
+    BenchRig rig;
+
+    // Untimed warm-up pass so hit-heavy really measures hits
+    for (const BenchRef& r : refs) {
+        rig.access(r.core, r.isWrite, r.address);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t tscStart = readTsc();
+    for (const BenchRef& r : refs) {
+        rig.access(r.core, r.isWrite, r.address);
+    }
+    uint64_t tscEnd = readTsc();
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    double refsPerSec = refs.size() / seconds;
+    double nsPerRef = seconds * 1e9 / refs.size();
+    double tscPerRef = double(tscEnd - tscStart) / refs.size();
+
+    std::cout << std::left << std::setw(12) << name
+              << std::right << std::fixed << std::setprecision(0)
+              << std::setw(12) << refsPerSec << " refs/s"
+              << std::setprecision(1)
+              << std::setw(10) << nsPerRef << " ns/ref"
+              << std::setw(10) << tscPerRef << " cyc/ref" << std::endl;
+}
+
+}  // namespace
+
+int main() {
+    const size_t NUM_REFS = 2000000;
+
+    // Hit-heavy: one core cycling through a working set that fits in the
+    // cache, so after warm-up every access hits
+    {
+        size_t workingSetBlocks = (1u << SET_INDEX_BITS) * ASSOCIATIVITY / 2;
+        std::vector<BenchRef> refs;
+        refs.reserve(NUM_REFS);
+        for (size_t i = 0; i < NUM_REFS; i++) {
+            unsigned int block = i % workingSetBlocks;
+            refs.push_back({0, (i % 8) == 0, block << BLOCK_OFFSET_BITS});
+        }
+        runStream("hit-heavy", refs);
+    }
+
+    // Miss-heavy: one core streaming through memory, each reference touches
+    // a new block and misses
+    {
+        std::vector<BenchRef> refs;
+        refs.reserve(NUM_REFS);
+        for (size_t i = 0; i < NUM_REFS; i++) {
+            refs.push_back({0, false, (unsigned int)(i << BLOCK_OFFSET_BITS)});
+        }
+        runStream("miss-heavy", refs);
+    }
+
+    // Ping-pong: two cores alternately writing the same block, forcing an
+    // invalidation and ownership transfer on every access
+    {
+        std::vector<BenchRef> refs;
+        refs.reserve(NUM_REFS);
+        for (size_t i = 0; i < NUM_REFS; i++) {
+            refs.push_back({(int)(i & 1), true, 0x1000});
+        }
+        runStream("ping-pong", refs);
+    }
+
+    return 0;
+}
@@ -2,8 +2,15 @@
 #include <string>
 #include <cstdlib>
 #include <getopt.h>
+#include <unistd.h>
+#include <csignal>
 #include <fstream>
 #include <iomanip>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <sstream>
 #include "Simulator.h"
 
 unsigned int currentGlobalCycle = 0;
@@ -16,12 +23,154 @@ void printHelp() {
               << "  -E <E>: associativity (number of cache lines per set)\n"
               << "  -b <b>: number of block bits (block size = B = 2^b)\n"
               << "  -o <outfilename>: logs output in file for plotting etc.\n"
-              << "  -h: prints this help\n";
+              << "  -r <policy>: replacement policy: lru (default), plru, random\n"
+              << "  -i <cycles>: sample statistics every N cycles into <outfile>.timeseries.csv\n"
+              << "  -c <ckptfile>: checkpoint to this file every 10M cycles (or on SIGUSR1)\n"
+              << "  -R: resume from the -c checkpoint file instead of starting fresh\n"
+              << "  -n <cores>: number of cores to simulate (default 4, up to 64 with -d)\n"
+              << "  -d: directory-based coherence instead of the snooping bus\n"
+              << "  -x: split-transaction bus (pipelined address/data phases)\n"
+              << "  -P: parallel engine, one host thread per simulated core\n"
+              << "  -a: ping-pong analysis, writes <output>.pingpong.txt\n"
+              << "  -f: event-driven fast-forward mode (approximate: misses stall their core\n"
+              << "      for the full latency, so results differ from the default engine under\n"
+              << "      contention; use -P for a speedup with identical results)\n"
+              << "  -S <csvfile>: sweep mode; -s/-E/-b may be ranges (lo:hi), results go to one CSV\n"
+              << "  -j <threads>: number of host threads for sweep mode (default: hardware threads)\n"
+              << "  -h: prints this help\n"
+              << "In sweep mode every (s, E, b) combination in the given ranges is simulated\n"
+              << "on an independent Simulator instance across a host thread pool.\n";
 }
 
-void writeFormattedOutput(const Simulator& simulator, const std::string& tracePrefix, 
-                         int setIndexBits, int associativity, int blockOffsetBits, 
-                         const std::string& outputFile) {
+// Parse a flag value that is either a single number ("4") or an
+// inclusive range ("2:6"). Returns false if the value is malformed.
+static bool parseRange(const std::string& value, int& lo, int& hi) {
+    size_t colon = value.find(':');
+    if (colon == std::string::npos) {
+        lo = hi = std::atoi(value.c_str());
+        return lo > 0;
+    }
+    lo = std::atoi(value.substr(0, colon).c_str());
+    hi = std::atoi(value.substr(colon + 1).c_str());
+    return lo > 0 && hi >= lo;
+}
+
+// One (s, E, b) point of a sweep, plus the results collected from its run
+struct SweepPoint {
+    int setIndexBits;
+    int associativity;
+    int blockOffsetBits;
+
+    int totalCycles = 0;
+    int maxExecutionTime = 0;
+    uint64_t accesses = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    uint64_t writebacks = 0;
+    uint64_t invalidations = 0;
+    uint64_t busTraffic = 0;
+};
+
+// Run every sweep point across a pool of host threads and write one CSV.
+// Each worker builds its own Simulator (with its own Bus/Cache/Processor
+// graph), so no state is shared between points.
+static int runSweep(const std::string& tracePrefix, int sLo, int sHi, int eLo, int eHi,
+                    int bLo, int bHi, bool eventDriven, int numThreads,
+                    ReplacementPolicy policy, const std::string& csvFile) {
+    // Enumerate the configuration grid
+    std::vector<SweepPoint> points;
+    for (int s = sLo; s <= sHi; s++) {
+        for (int E = eLo; E <= eHi; E++) {
+            for (int b = bLo; b <= bHi; b++) {
+                SweepPoint point;
+                point.setIndexBits = s;
+                point.associativity = E;
+                point.blockOffsetBits = b;
+                points.push_back(point);
+            }
+        }
+    }
+
+    if (numThreads <= 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    numThreads = std::min<int>(numThreads, points.size());
+
+    std::cout << "Sweeping " << points.size() << " configurations on "
+              << numThreads << " threads..." << std::endl;
+
+    // Workers pull the next unclaimed point from a shared counter
+    std::atomic<size_t> nextPoint(0);
+    auto worker = [&]() {
+        for (;;) {
+            size_t index = nextPoint.fetch_add(1);
+            if (index >= points.size()) {
+                break;
+            }
+            SweepPoint& point = points[index];
+
+            Simulator simulator(tracePrefix, point.setIndexBits, point.associativity,
+                                point.blockOffsetBits, "", 4, policy);
+            simulator.setEventDriven(eventDriven);
+            simulator.runSimulation();
+
+            // Collect results from this instance
+            point.totalCycles = simulator.getCurrentCycle();
+            for (const auto& processor : simulator.getProcessors()) {
+                int totalTime = processor->getTotalCycles() + processor->getIdleCycles();
+                point.maxExecutionTime = std::max(point.maxExecutionTime, totalTime);
+            }
+            for (const auto& cache : simulator.getCaches()) {
+                const Statistics& cacheStats = cache->getStatistics();
+                point.accesses += cacheStats.getAccesses();
+                point.misses += cacheStats.getMisses();
+                point.evictions += cacheStats.getEvictions();
+                point.writebacks += cacheStats.getWritebacks();
+                point.invalidations += cacheStats.getInvalidations();
+                point.busTraffic += cacheStats.getBusTraffic();
+            }
+            const Statistics& busStats = simulator.getBus()->getStatistics();
+            point.invalidations += busStats.getInvalidations();
+            point.busTraffic += busStats.getBusTraffic();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numThreads; i++) {
+        threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Write the consolidated CSV
+    std::ofstream csv(csvFile);
+    if (!csv.is_open()) {
+        std::cerr << "Error: Could not open output file: " << csvFile << std::endl;
+        return 1;
+    }
+
+    csv << "s,E,b,cache_kb,total_cycles,max_execution_time,accesses,misses,"
+        << "miss_rate_pct,evictions,writebacks,invalidations,bus_traffic_bytes\n";
+    for (const SweepPoint& point : points) {
+        double cacheSizeKB = ((1 << point.setIndexBits) * point.associativity *
+                              (1 << point.blockOffsetBits)) / 1024.0;
+        double missRate = point.accesses > 0 ? 100.0 * point.misses / point.accesses : 0.0;
+        csv << point.setIndexBits << "," << point.associativity << ","
+            << point.blockOffsetBits << "," << std::fixed << std::setprecision(2)
+            << cacheSizeKB << "," << point.totalCycles << "," << point.maxExecutionTime << ","
+            << point.accesses << "," << point.misses << "," << missRate << ","
+            << point.evictions << "," << point.writebacks << ","
+            << point.invalidations << "," << point.busTraffic << "\n";
+    }
+
+    std::cout << "Sweep results written to " << csvFile << std::endl;
+    return 0;
+}
+
+void writeFormattedOutput(const Simulator& simulator, const std::string& tracePrefix,
+                         int setIndexBits, int associativity, int blockOffsetBits,
+                         ReplacementPolicy policy, const std::string& outputFile) {
     std::ofstream outFile;
     std::ostream& out = outputFile.empty() ? std::cout : outFile;
     
@@ -49,7 +198,7 @@ void writeFormattedOutput(const Simulator& simulator, const std::string& tracePr
     out << "Cache Size (KB per core): " << std::fixed << std::setprecision(2) << cacheSizeKB << std::endl;
     out << "MESI Protocol: Enabled" << std::endl;
     out << "Write Policy: Write-back, Write-allocate" << std::endl;
-    out << "Replacement Policy: LRU" << std::endl;
+    out << "Replacement Policy: " << replacementPolicyName(policy) << std::endl;
     out << "Bus: Central snooping bus" << std::endl;
     out << std::endl;
     
@@ -108,30 +257,93 @@ void writeFormattedOutput(const Simulator& simulator, const std::string& tracePr
 int main(int argc, char* argv[]) {
     // Default parameters
     std::string tracePrefix = "";
-    int setIndexBits = 6;      // 64 sets by default
-    int associativity = 2;     // 2-way set associative by default
-    int blockOffsetBits = 5;   // 32-byte blocks by default
+    int setIndexBits = 6, setIndexBitsHi = 6;          // 64 sets by default
+    int associativity = 2, associativityHi = 2;        // 2-way set associative by default
+    int blockOffsetBits = 5, blockOffsetBitsHi = 5;    // 32-byte blocks by default
     std::string outputFile = "";
-    
+    std::string sweepCsvFile = "";
+    ReplacementPolicy policy = ReplacementPolicy::LRU;
+    int samplingInterval = 0;
+    std::string checkpointFile = "";
+    bool resume = false;
+    bool eventDriven = false;
+    bool directoryMode = false;
+    bool splitBusMode = false;
+    bool parallelEngine = false;
+    bool pingPongAnalysis = false;
+    int numCores = 4;
+    int numThreads = 0;
+
     // Parse command line arguments
     int opt;
-    while ((opt = getopt(argc, argv, "t:s:E:b:o:h")) != -1) {
+    bool rangesValid = true;
+    while ((opt = getopt(argc, argv, "t:s:E:b:o:S:j:r:i:c:n:RadxfPh")) != -1) {
         switch (opt) {
             case 't':
                 tracePrefix = optarg;
                 break;
             case 's':
-                setIndexBits = std::atoi(optarg);
+                rangesValid = parseRange(optarg, setIndexBits, setIndexBitsHi) && rangesValid;
                 break;
             case 'E':
-                associativity = std::atoi(optarg);
+                rangesValid = parseRange(optarg, associativity, associativityHi) && rangesValid;
                 break;
             case 'b':
-                blockOffsetBits = std::atoi(optarg);
+                rangesValid = parseRange(optarg, blockOffsetBits, blockOffsetBitsHi) && rangesValid;
                 break;
             case 'o':
                 outputFile = optarg;
                 break;
+            case 'S':
+                sweepCsvFile = optarg;
+                break;
+            case 'r': {
+                std::string name = optarg;
+                if (name == "lru") {
+                    policy = ReplacementPolicy::LRU;
+                } else if (name == "plru") {
+                    policy = ReplacementPolicy::PLRU;
+                } else if (name == "random") {
+                    policy = ReplacementPolicy::RANDOM;
+                } else {
+                    std::cerr << "Error: Unknown replacement policy: " << name << std::endl;
+                    return 1;
+                }
+                break;
+            }
+            case 'j':
+                numThreads = std::atoi(optarg);
+                break;
+            case 'i':
+                samplingInterval = std::atoi(optarg);
+                break;
+            case 'c':
+                checkpointFile = optarg;
+                break;
+            case 'R':
+                resume = true;
+                break;
+            case 'n':
+                numCores = std::atoi(optarg);
+                break;
+            case 'd':
+                directoryMode = true;
+                break;
+            case 'x':
+                splitBusMode = true;
+                break;
+            case 'P':
+                parallelEngine = true;
+                break;
+            case 'a':
+                pingPongAnalysis = true;
+                break;
+            case 'f':
+                eventDriven = true;
+                std::cerr << "Note: -f is an approximate timing model; results can differ "
+                          << "from the default engine under contention (use -P for a "
+                          << "speedup with identical results)." << std::endl;
+                break;
             case 'h':
                 printHelp();
                 return 0;
@@ -141,28 +353,72 @@ int main(int argc, char* argv[]) {
                 return 1;
         }
     }
-    
+
     // Validate parameters
     if (tracePrefix.empty()) {
         std::cerr << "Error: Trace file prefix (-t) is required." << std::endl;
         printHelp();
         return 1;
     }
-    
-    if (setIndexBits <= 0 || associativity <= 0 || blockOffsetBits <= 0) {
-        std::cerr << "Error: Cache parameters must be positive." << std::endl;
+
+    if (!rangesValid || setIndexBits <= 0 || associativity <= 0 || blockOffsetBits <= 0) {
+        std::cerr << "Error: Cache parameters must be positive (ranges as lo:hi)." << std::endl;
         return 1;
     }
-    
+
+    int maxCores = directoryMode ? 64 : 32;
+    if (numCores <= 0 || numCores > maxCores) {
+        std::cerr << "Error: Core count must be between 1 and " << maxCores
+                  << (directoryMode ? "" : " (64 with -d)") << "." << std::endl;
+        return 1;
+    }
+
+    // Sweep mode: run every configuration in the ranges across a thread pool
+    if (!sweepCsvFile.empty()) {
+        return runSweep(tracePrefix, setIndexBits, setIndexBitsHi, associativity,
+                        associativityHi, blockOffsetBits, blockOffsetBitsHi,
+                        eventDriven, numThreads, policy, sweepCsvFile);
+    }
+
+    // Single-run mode expects single values, not ranges
+    if (setIndexBitsHi != setIndexBits || associativityHi != associativity ||
+        blockOffsetBitsHi != blockOffsetBits) {
+        std::cerr << "Error: Ranges for -s/-E/-b require sweep mode (-S <csvfile>)." << std::endl;
+        return 1;
+    }
+
     // Create and run the simulator
     
-    Simulator simulator(tracePrefix, setIndexBits, associativity, blockOffsetBits, outputFile);
-    alarm(60); 
-    simulator.runSimulation();
+    Simulator simulator(tracePrefix, setIndexBits, associativity, blockOffsetBits, outputFile,
+                        numCores, policy, directoryMode, splitBusMode);
+    simulator.setEventDriven(eventDriven);
+    simulator.setParallel(parallelEngine);
+    simulator.setContentionAnalysis(pingPongAnalysis);
+    simulator.setSamplingInterval(samplingInterval);
+    if (!checkpointFile.empty()) {
+        // Periodic snapshots, plus one on demand via SIGUSR1
+        simulator.setCheckpointing(checkpointFile, 10000000);
+        std::signal(SIGUSR1, [](int) { Simulator::checkpointRequested = 1; });
+    }
+    alarm(60);
+    if (resume) {
+        if (checkpointFile.empty()) {
+            std::cerr << "Error: -R requires a checkpoint file (-c)." << std::endl;
+            return 1;
+        }
+        if (!simulator.resumeSimulation(checkpointFile)) {
+            // Don't write an all-zero report for a run that never happened
+            std::cerr << "Error: Resume failed; no output written." << std::endl;
+            return 1;
+        }
+    } else {
+        simulator.runSimulation();
+    }
     
     
     // Generate formatted output
-    writeFormattedOutput(simulator, tracePrefix, setIndexBits, associativity, blockOffsetBits, outputFile);
+    writeFormattedOutput(simulator, tracePrefix, setIndexBits, associativity, blockOffsetBits,
+                         policy, outputFile);
     
     return 0;
 }
\ No newline at end of file
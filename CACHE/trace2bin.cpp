@@ -0,0 +1,54 @@
+#include <iostream>
+#include <string>
+#include "TraceReader.h"
+
+// Converts trace files into the packed binary format (4-byte magic, then
+// 5-byte records: op byte + little-endian uint32 address), or with -c into
+// the compressed format (delta-encoded addresses, varint-packed, framed in
+// independently decodable blocks).
+// Usage: ./trace2bin [-c] <file.trace> [<file.trace> ...]
+// Each input file produces a <file>.btrace (or <file>.ctrace) next to it.
+
+static std::string makeOutputPath(const std::string& inputPath, bool compressed) {
+    // Replace a trailing ".trace" with the new extension, otherwise append
+    const std::string suffix = ".trace";
+    const std::string extension = compressed ? ".ctrace" : ".btrace";
+    if (inputPath.size() > suffix.size() &&
+        inputPath.compare(inputPath.size() - suffix.size(), suffix.size(), suffix) == 0) {
+        return inputPath.substr(0, inputPath.size() - suffix.size()) + extension;
+    }
+    return inputPath + extension;
+}
+
+int main(int argc, char* argv[]) {
+    bool compressed = false;
+    int firstInput = 1;
+    if (argc > 1 && std::string(argv[1]) == "-c") {
+        compressed = true;
+        firstInput = 2;
+    }
+
+    if (argc <= firstInput) {
+        std::cerr << "Usage: " << argv[0] << " [-c] <file.trace> [<file.trace> ...]" << std::endl;
+        return 1;
+    }
+
+    int failures = 0;
+    for (int i = firstInput; i < argc; i++) {
+        std::string inputPath = argv[i];
+        std::string outputPath = makeOutputPath(inputPath, compressed);
+
+        long count = compressed
+                         ? TraceReader::convertToCompressed(inputPath, outputPath)
+                         : TraceReader::convertToBinary(inputPath, outputPath);
+        if (count < 0) {
+            std::cerr << "Error: Failed to convert " << inputPath << std::endl;
+            failures++;
+            continue;
+        }
+
+        std::cout << inputPath << " -> " << outputPath << " (" << count << " references)" << std::endl;
+    }
+
+    return failures > 0 ? 1 : 0;
+}
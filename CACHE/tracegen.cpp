@@ -0,0 +1,219 @@
+// tracegen.cpp
+//
+// Synthetic trace generator (grown out of matrix_vector_mult.cpp, whose
+// false-sharing demonstration survives as the "falsesharing" pattern).
+// The old generator formatted every address through iostream and flushed
+// with std::endl, so producing a few million references took longer than
+// simulating them. This version formats into a large buffer flushed with
+// fwrite, and can emit either the text trace format or the binary "BTR1"
+// format understood by TraceReader, so hundred-million-reference inputs
+// are practical.
+//
+// Patterns:
+//   stream       - each core streams sequentially through its own region
+//   random       - uniform random addresses within a per-core footprint
+//   chase        - pointer-chase: each address is derived from the last,
+//                  so the stream has no spatial locality at all
+//   truesharing  - cores read/write a small set of genuinely shared words
+//   falsesharing - cores write different words of the same cache block
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <unistd.h>
+
+// Matches TraceReader's binary container: "BTR1" then 5-byte records
+static const uint32_t BINARY_MAGIC = 0x31525442;
+
+// Buffered trace writer: batches formatted records and flushes with fwrite
+class TraceWriter {
+private:
+    std::FILE* file;
+    std::vector<char> buffer;
+    size_t used;
+    bool binary;
+
+    void flush() {
+        if (used > 0) {
+            std::fwrite(buffer.data(), 1, used, file);
+            used = 0;
+        }
+    }
+
+public:
+    TraceWriter(const std::string& filename, bool binaryFormat)
+        : file(nullptr), buffer(1 << 20), used(0), binary(binaryFormat) {
+        file = std::fopen(filename.c_str(), "wb");
+        if (!file) {
+            std::cerr << "Error: Could not open trace file: " << filename << std::endl;
+            std::exit(1);
+        }
+        if (binary) {
+            std::fwrite(&BINARY_MAGIC, sizeof(BINARY_MAGIC), 1, file);
+        }
+    }
+
+    ~TraceWriter() {
+        flush();
+        std::fclose(file);
+    }
+
+    void emit(bool isWrite, uint32_t address) {
+        // Worst case record: "W 0xffffffff\n" = 13 bytes text, 5 binary
+        if (used + 16 > buffer.size()) {
+            flush();
+        }
+        char* p = buffer.data() + used;
+        if (binary) {
+            p[0] = isWrite ? 1 : 0;
+            p[1] = (char)(address & 0xFF);
+            p[2] = (char)((address >> 8) & 0xFF);
+            p[3] = (char)((address >> 16) & 0xFF);
+            p[4] = (char)((address >> 24) & 0xFF);
+            used += 5;
+        } else {
+            *p++ = isWrite ? 'W' : 'R';
+            *p++ = ' ';
+            *p++ = '0';
+            *p++ = 'x';
+            // Hex without leading zeros, like the original generator
+            static const char digits[] = "0123456789abcdef";
+            int shift = 28;
+            while (shift > 0 && ((address >> shift) & 0xF) == 0) {
+                shift -= 4;
+            }
+            for (; shift >= 0; shift -= 4) {
+                *p++ = digits[(address >> shift) & 0xF];
+            }
+            *p++ = '\n';
+            used = p - buffer.data();
+        }
+    }
+};
+
+// Small deterministic PRNG (same LCG constants used elsewhere in the tree)
+struct Lcg {
+    uint32_t state;
+    explicit Lcg(uint32_t seed) : state(seed) {}
+    uint32_t next() {
+        state = state * 1664525u + 1013904223u;
+        return state;
+    }
+};
+
+static void printHelp(const char* prog) {
+    std::cout << "Usage: " << prog << " [options]\n"
+              << "  -p <pattern>: stream, random, chase, truesharing, falsesharing\n"
+              << "  -n <refs>: references per core (default 1000000)\n"
+              << "  -c <cores>: number of cores / trace files (default 4)\n"
+              << "  -o <prefix>: output prefix, writes <prefix>_procN.trace (default synth)\n"
+              << "  -w <percent>: write fraction, 0-100 (default 25)\n"
+              << "  -F <bytes>: per-core footprint for random/chase (default 1048576)\n"
+              << "  -i <percent>: shared-reference intensity for truesharing (default 50)\n"
+              << "  -B: emit the binary BTR1 format instead of text\n"
+              << "  -h: show this help\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::string pattern = "stream";
+    std::string prefix = "synth";
+    long numRefs = 1000000;
+    int numCores = 4;
+    int writePercent = 25;
+    long footprint = 1 << 20;
+    int sharePercent = 50;
+    bool binaryFormat = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "p:n:c:o:w:F:i:Bh")) != -1) {
+        switch (opt) {
+            case 'p': pattern = optarg; break;
+            case 'n': numRefs = std::atol(optarg); break;
+            case 'c': numCores = std::atoi(optarg); break;
+            case 'o': prefix = optarg; break;
+            case 'w': writePercent = std::atoi(optarg); break;
+            case 'F': footprint = std::atol(optarg); break;
+            case 'i': sharePercent = std::atoi(optarg); break;
+            case 'B': binaryFormat = true; break;
+            case 'h': printHelp(argv[0]); return 0;
+            default: printHelp(argv[0]); return 1;
+        }
+    }
+
+    if (numRefs <= 0 || numCores <= 0 || footprint <= 0 ||
+        writePercent < 0 || writePercent > 100 ||
+        sharePercent < 0 || sharePercent > 100) {
+        std::cerr << "Error: Invalid generator parameters." << std::endl;
+        return 1;
+    }
+
+    // Keep footprints block-aligned so patterns behave as described
+    footprint &= ~31L;
+
+    for (int core = 0; core < numCores; core++) {
+        std::string filename = prefix + "_proc" + std::to_string(core) + ".trace";
+        TraceWriter writer(filename, binaryFormat);
+        Lcg rng(0x9E3779B9u ^ (uint32_t)core);
+
+        // Each core gets its own private region; a low shared region is
+        // used by the sharing patterns
+        uint32_t privateBase = 0x10000000u + (uint32_t)core * (uint32_t)footprint;
+        uint32_t sharedBase = 0x1000u;
+
+        if (pattern == "stream") {
+            for (long i = 0; i < numRefs; i++) {
+                bool isWrite = (int)(rng.next() % 100) < writePercent;
+                writer.emit(isWrite, privateBase + (uint32_t)((i * 4) % footprint));
+            }
+        } else if (pattern == "random") {
+            for (long i = 0; i < numRefs; i++) {
+                uint32_t offset = (rng.next() % (uint32_t)footprint) & ~3u;
+                bool isWrite = (int)(rng.next() % 100) < writePercent;
+                writer.emit(isWrite, privateBase + offset);
+            }
+        } else if (pattern == "chase") {
+            // Each address is a scramble of the previous one, so the
+            // simulator sees a dependent chain with no locality
+            uint32_t cursor = rng.next();
+            for (long i = 0; i < numRefs; i++) {
+                cursor = cursor * 1664525u + 1013904223u;
+                uint32_t offset = (cursor % (uint32_t)footprint) & ~3u;
+                bool isWrite = (int)(rng.next() % 100) < writePercent;
+                writer.emit(isWrite, privateBase + offset);
+            }
+        } else if (pattern == "truesharing") {
+            // A fraction of references touch the same 16 shared words;
+            // the rest stay in the core's private region
+            for (long i = 0; i < numRefs; i++) {
+                bool isWrite = (int)(rng.next() % 100) < writePercent;
+                if ((int)(rng.next() % 100) < sharePercent) {
+                    writer.emit(isWrite, sharedBase + (rng.next() % 16) * 4);
+                } else {
+                    writer.emit(isWrite, privateBase + ((rng.next() % (uint32_t)footprint) & ~3u));
+                }
+            }
+        } else if (pattern == "falsesharing") {
+            // Every core hammers its own word of one shared cache block,
+            // exactly the y_falsesharing case from the original generator
+            uint32_t myWord = sharedBase + (uint32_t)core * 4;
+            for (long i = 0; i < numRefs; i++) {
+                writer.emit(true, myWord);
+                writer.emit(false, myWord);
+            }
+        } else {
+            std::cerr << "Error: Unknown pattern: " << pattern << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "Generated " << numCores << " trace files with prefix '" << prefix
+              << "' (" << pattern << ", " << numRefs << " refs/core, "
+              << (binaryFormat ? "binary" : "text") << ")." << std::endl;
+    std::cout << "Run the simulator with: ./L1simulate -t " << prefix
+              << " -s 6 -E 2 -b 5 -o " << prefix << "_results.txt" << std::endl;
+
+    return 0;
+}
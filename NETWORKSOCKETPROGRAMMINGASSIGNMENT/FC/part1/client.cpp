@@ -5,10 +5,13 @@
 #include <map>
 #include <vector>
 #include <cstring>
+#include <deque>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
 #include <chrono>
 #include <json/json.h> // You'll need to install jsoncpp: sudo apt-get install libjsoncpp-dev
 
@@ -79,99 +82,316 @@ map<string, int> countWords(const vector<string>& words) {
     return wordCount;
 }
 
-// Function to download words from server
+// Function to connect to the server (one connection for the whole download)
+int connectToServer(const Config& config) {
+    // Create socket
+    int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+    if (sockfd < 0) {
+        cerr << "Error creating socket" << endl;
+        exit(1);
+    }
+
+    // Server address setup
+    struct sockaddr_in serverAddr;
+    memset(&serverAddr, 0, sizeof(serverAddr));
+    serverAddr.sin_family = AF_INET;
+    serverAddr.sin_port = htons(config.server_port);
+
+    if (inet_pton(AF_INET, config.server_ip.c_str(), &serverAddr.sin_addr) <= 0) {
+        cerr << "Invalid address" << endl;
+        close(sockfd);
+        exit(1);
+    }
+
+    // Connect to server
+    if (connect(sockfd, (struct sockaddr*)&serverAddr, sizeof(serverAddr)) < 0) {
+        cerr << "Connection failed" << endl;
+        close(sockfd);
+        exit(1);
+    }
+
+    return sockfd;
+}
+
+// Function to send one p,k\n request on the persistent connection
+void sendRequest(int sockfd, int offset, int k) {
+    string request = to_string(offset) + "," + to_string(k) + "\n";
+    if (send(sockfd, request.c_str(), request.length(), 0) < 0) {
+        cerr << "Send failed" << endl;
+        close(sockfd);
+        exit(1);
+    }
+}
+
+// Function to read one newline-terminated response; pipelined responses
+// arriving in the same recv are kept in the pending buffer for the next call
+bool readResponseLine(int sockfd, string& pending, string& response) {
+    size_t newlinePos;
+    while ((newlinePos = pending.find('\n')) == string::npos) {
+        char buffer[4096];
+        int bytesReceived = recv(sockfd, buffer, sizeof(buffer), 0);
+        if (bytesReceived <= 0) {
+            return false;
+        }
+        pending.append(buffer, bytesReceived);
+    }
+
+    response = pending.substr(0, newlinePos);
+    pending.erase(0, newlinePos + 1);
+    return true;
+}
+
+// Function to download words from server over one persistent connection,
+// keeping the next request in flight while the current response is read
+// so connection setup and a round trip per request are no longer paid
 vector<string> downloadWords(const Config& config) {
     vector<string> allWords;
-    int offset = config.p;
+    int sockfd = connectToServer(config);
+    string pending;
+
+    int nextOffset = config.p;
+    int inFlight = 0;
     bool done = false;
-    
-    while (!done) {
-        // Create socket
-        int sockfd = socket(AF_INET, SOCK_STREAM, 0);
-        if (sockfd < 0) {
-            cerr << "Error creating socket" << endl;
-            exit(1);
-        }
-        
-        // Server address setup
-        struct sockaddr_in serverAddr;
-        memset(&serverAddr, 0, sizeof(serverAddr));
-        serverAddr.sin_family = AF_INET;
-        serverAddr.sin_port = htons(config.server_port);
-        
-        if (inet_pton(AF_INET, config.server_ip.c_str(), &serverAddr.sin_addr) <= 0) {
-            cerr << "Invalid address" << endl;
-            close(sockfd);
-            exit(1);
-        }
-        
-        // Connect to server
-        if (connect(sockfd, (struct sockaddr*)&serverAddr, sizeof(serverAddr)) < 0) {
-            cerr << "Connection failed" << endl;
-            close(sockfd);
-            exit(1);
-        }
-        
-        // Send request: p,k\n
-        string request = to_string(offset) + "," + to_string(config.k) + "\n";
-        if (send(sockfd, request.c_str(), request.length(), 0) < 0) {
-            cerr << "Send failed" << endl;
-            close(sockfd);
-            exit(1);
+
+    // Prime the pipeline with the first request
+    sendRequest(sockfd, nextOffset, config.k);
+    nextOffset += config.k;
+    inFlight++;
+
+    while (inFlight > 0) {
+        // Pipeline the next request before reading the current response;
+        // the server returns exactly k words until EOF, so the next
+        // offset is known without waiting
+        if (!done) {
+            sendRequest(sockfd, nextOffset, config.k);
+            nextOffset += config.k;
+            inFlight++;
         }
-        
-        // Receive response
-        char buffer[4096];
-        memset(buffer, 0, sizeof(buffer));
+
         string response;
-        
-        // Read until we get a newline
-        while (response.find('\n') == string::npos) {
-            int bytesReceived = recv(sockfd, buffer, sizeof(buffer) - 1, 0);
-            if (bytesReceived <= 0) {
-                break;
-            }
-            buffer[bytesReceived] = '\0';
-            response += buffer;
+        if (!readResponseLine(sockfd, pending, response)) {
+            break;
         }
-        
-        // Remove the newline
-        if (!response.empty() && response.back() == '\n') {
-            response.pop_back();
-        }
-        
-        // Close connection
-        close(sockfd);
-        
+        inFlight--;
+
         // Parse response
         vector<string> words = split(response, ',');
-        
+
         // Check for EOF
-        bool hasEOF = false;
         for (const string& word : words) {
             string trimmed = word;
             trimmed.erase(0, trimmed.find_first_not_of(" \t\r\n"));
             trimmed.erase(trimmed.find_last_not_of(" \t\r\n") + 1);
-            
+
             if (trimmed == "EOF") {
-                hasEOF = true;
                 done = true;
-            } else if (!trimmed.empty()) {
+            } else if (!trimmed.empty() && !done) {
                 allWords.push_back(trimmed);
             }
         }
-        
-        // If we got EOF as the only response, we're done
-        if (words.size() == 1 && hasEOF) {
-            done = true;
+    }
+
+    close(sockfd);
+    return allWords;
+}
+
+// Function to stream word frequencies with bounded memory: words are
+// parsed out of each received chunk as it arrives and folded straight
+// into the frequency map, so neither a response nor the word list is
+// ever held in memory — only the recv chunk and the partial word at a
+// chunk boundary. This is the mode for very large k, where a single
+// response can run to many megabytes
+void downloadWordFrequencies(const Config& config, map<string, int>& wordCount) {
+    int sockfd = connectToServer(config);
+
+    int nextOffset = config.p;
+    int inFlight = 0;
+    bool done = false;
+
+    // Prime the pipeline with the first request plus one ahead
+    sendRequest(sockfd, nextOffset, config.k);
+    nextOffset += config.k;
+    inFlight++;
+    sendRequest(sockfd, nextOffset, config.k);
+    nextOffset += config.k;
+    inFlight++;
+
+    string token;   // partial word spanning a chunk boundary
+    char buffer[4096];
+
+    while (inFlight > 0) {
+        int bytesReceived = recv(sockfd, buffer, sizeof(buffer), 0);
+        if (bytesReceived <= 0) {
+            break;
         }
-        
-        // Update offset for next request
-        if (!done) {
-            offset += config.k;
+
+        // Incremental parse: a chunk may end mid-word, span several
+        // pipelined responses, or both
+        for (int i = 0; i < bytesReceived; i++) {
+            char c = buffer[i];
+            if (c == ',' || c == '\n') {
+                if (token == "EOF") {
+                    done = true;
+                } else if (!token.empty() && !done) {
+                    wordCount[token]++;
+                }
+                token.clear();
+                if (c == '\n') {
+                    // One response fully consumed; keep one request
+                    // pipelined ahead until EOF
+                    inFlight--;
+                    if (!done) {
+                        sendRequest(sockfd, nextOffset, config.k);
+                        nextOffset += config.k;
+                        inFlight++;
+                    }
+                }
+            } else if (c != '\r' && c != ' ' && c != '\t') {
+                token += c;
+            }
         }
     }
-    
+
+    close(sockfd);
+}
+
+// One connection of the async download: its nonblocking socket, bytes
+// waiting to go out, bytes received past the last complete response,
+// and the offsets of the requests it is still owed answers for (the
+// server answers each connection's requests in order)
+struct AsyncConnection {
+    int sockfd;
+    string outbox;
+    string inbox;
+    deque<int> inFlightOffsets;
+};
+
+// Function to download words asynchronously: a poll loop over several
+// nonblocking connections keeps `windowSize` requests outstanding at
+// once, so total fetch time is bounded by bandwidth rather than
+// round-trips x latency. Responses are reassembled in offset order, so
+// the returned word list is identical to the synchronous path's
+vector<string> downloadWordsAsync(const Config& config, int connectionCount, int windowSize) {
+    if (connectionCount < 1) connectionCount = 1;
+    if (windowSize < connectionCount) windowSize = connectionCount;
+
+    vector<AsyncConnection> connections(connectionCount);
+    for (auto& connection : connections) {
+        connection.sockfd = connectToServer(config);
+        // Nonblocking from here on; the poll loop drives all progress
+        fcntl(connection.sockfd, F_SETFL,
+              fcntl(connection.sockfd, F_GETFL, 0) | O_NONBLOCK);
+    }
+
+    map<int, vector<string>> responsesByOffset;   // reassembly buffer
+    int nextOffset = config.p;
+    int inFlight = 0;
+    bool eofSeen = false;
+
+    vector<struct pollfd> pollSet(connectionCount);
+
+    while (true) {
+        // Issue requests round-robin onto the least-loaded connection
+        // until the window is full (or EOF already answered everything)
+        while (!eofSeen && inFlight < windowSize) {
+            AsyncConnection* target = &connections[0];
+            for (auto& connection : connections) {
+                if (connection.inFlightOffsets.size() < target->inFlightOffsets.size()) {
+                    target = &connection;
+                }
+            }
+            target->outbox += to_string(nextOffset) + "," + to_string(config.k) + "\n";
+            target->inFlightOffsets.push_back(nextOffset);
+            nextOffset += config.k;
+            inFlight++;
+        }
+
+        if (inFlight == 0) {
+            break;   // EOF seen and every response accounted for
+        }
+
+        for (int i = 0; i < connectionCount; i++) {
+            pollSet[i].fd = connections[i].sockfd;
+            pollSet[i].events = POLLIN;
+            if (!connections[i].outbox.empty()) pollSet[i].events |= POLLOUT;
+            pollSet[i].revents = 0;
+        }
+
+        if (poll(pollSet.data(), connectionCount, -1) < 0) {
+            if (errno == EINTR) continue;
+            cerr << "Poll failed" << endl;
+            exit(1);
+        }
+
+        for (int i = 0; i < connectionCount; i++) {
+            AsyncConnection& connection = connections[i];
+
+            // Flush as much queued request data as the socket accepts
+            if (pollSet[i].revents & POLLOUT) {
+                ssize_t sent = send(connection.sockfd, connection.outbox.data(),
+                                    connection.outbox.size(), 0);
+                if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                    cerr << "Send failed" << endl;
+                    exit(1);
+                }
+                if (sent > 0) connection.outbox.erase(0, sent);
+            }
+
+            if (pollSet[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+                char buffer[4096];
+                ssize_t bytesReceived = recv(connection.sockfd, buffer, sizeof(buffer), 0);
+                if (bytesReceived < 0) {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) continue;
+                    cerr << "Receive failed" << endl;
+                    exit(1);
+                }
+                if (bytesReceived == 0) {
+                    cerr << "Server closed connection with "
+                         << connection.inFlightOffsets.size()
+                         << " requests outstanding" << endl;
+                    exit(1);
+                }
+                connection.inbox.append(buffer, bytesReceived);
+
+                // Each complete line answers this connection's oldest
+                // outstanding request
+                size_t newlinePos;
+                while ((newlinePos = connection.inbox.find('\n')) != string::npos) {
+                    string response = connection.inbox.substr(0, newlinePos);
+                    connection.inbox.erase(0, newlinePos + 1);
+
+                    int responseOffset = connection.inFlightOffsets.front();
+                    connection.inFlightOffsets.pop_front();
+                    inFlight--;
+
+                    vector<string>& words = responsesByOffset[responseOffset];
+                    for (const string& token : split(response, ',')) {
+                        string trimmed = token;
+                        trimmed.erase(0, trimmed.find_first_not_of(" \t\r\n"));
+                        trimmed.erase(trimmed.find_last_not_of(" \t\r\n") + 1);
+
+                        if (trimmed == "EOF") {
+                            eofSeen = true;
+                            break;
+                        } else if (!trimmed.empty()) {
+                            words.push_back(trimmed);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    for (auto& connection : connections) {
+        close(connection.sockfd);
+    }
+
+    // Reassemble in offset order (the map is ordered; offsets past EOF
+    // hold empty word lists and contribute nothing)
+    vector<string> allWords;
+    for (const auto& entry : responsesByOffset) {
+        allWords.insert(allWords.end(), entry.second.begin(), entry.second.end());
+    }
     return allWords;
 }
 
@@ -185,15 +405,40 @@ void printWordFrequencies(const map<string, int>& wordCount) {
 int main(int argc, char* argv[]) {
     // Parse config
     Config config = parseConfig("config.json");
+
+    // --async [--window N] [--connections N]: overlap many requests
+    // instead of the strictly synchronous send/read/repeat loop
+    bool asyncMode = false;
+    bool streamMode = false;
+    int windowSize = 16;
+    int connectionCount = 4;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--async") {
+            asyncMode = true;
+        } else if (arg == "--stream") {
+            streamMode = true;
+        } else if (arg == "--window" && i + 1 < argc) {
+            windowSize = atoi(argv[++i]);
+        } else if (arg == "--connections" && i + 1 < argc) {
+            connectionCount = atoi(argv[++i]);
+        }
+    }
     
     // Start timing
     auto start = high_resolution_clock::now();
     
-    // Download words
-    vector<string> words = downloadWords(config);
-    
-    // Count word frequencies
-    map<string, int> wordCount = countWords(words);
+    // Download words and count frequencies. --stream folds words into
+    // the map as bytes arrive and never materializes the word list
+    map<string, int> wordCount;
+    if (streamMode) {
+        downloadWordFrequencies(config, wordCount);
+    } else {
+        vector<string> words = asyncMode
+            ? downloadWordsAsync(config, connectionCount, windowSize)
+            : downloadWords(config);
+        wordCount = countWords(words);
+    }
     
     // End timing
     auto end = high_resolution_clock::now();
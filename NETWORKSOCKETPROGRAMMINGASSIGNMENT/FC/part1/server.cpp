@@ -4,11 +4,22 @@
 #include <fstream>
 #include <vector>
 #include <cstring>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <sys/socket.h>
+#include <sys/epoll.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <signal.h>
+#include <sys/uio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <cstdint>
+#include <cstdio>
 #include <json/json.h>
 
 using namespace std;
@@ -114,84 +125,373 @@ pair<int, int> parseRequest(const string& request) {
     return make_pair(p, k);
 }
 
-// Build response based on request
-string buildResponse(const vector<string>& words, int p, int k) {
-    string response;
-    int totalWords = words.size();
-    
+// All words joined by commas in one contiguous buffer, plus a prefix
+// array of byte offsets. Words [p, p+k) are then one contiguous span of
+// the buffer, so a response needs no per-word string assembly at all.
+// The data either lives in the owned members (store built fresh from
+// the text file) or is served straight out of the mmap'd cache file
+struct WordStore {
+    string ownedBuffer;               // "w0,w1,...,wn-1" when built fresh
+    vector<uint64_t> ownedOffsets;
+
+    const char* buffer;               // always valid, whichever the source
+    const uint64_t* offsets;          // offsets[i] = start of word i; one
+                                      // extra entry one past a virtual
+                                      // comma after the last word, so the
+                                      // span [p, e) has length
+                                      // offsets[e]-1-offsets[p]
+    uint64_t wordCount;
+
+    WordStore() : buffer(NULL), offsets(NULL), wordCount(0) {}
+};
+
+// On-disk layout of the preprocessed cache (<words file>.bin): this
+// header, then the wordCount+1 offsets, then the joined word buffer.
+// sourceMtime ties the cache to the text file it was compiled from
+struct StoreCacheHeader {
+    char magic[8];                    // "FCWORDS1"
+    uint64_t sourceMtime;
+    uint64_t wordCount;
+    uint64_t bufferSize;
+};
+
+static const char STORE_CACHE_MAGIC[8] = {'F', 'C', 'W', 'O', 'R', 'D', 'S', '1'};
+
+// Build the contiguous store from the parsed word list
+WordStore buildWordStore(const vector<string>& words) {
+    WordStore store;
+    size_t totalBytes = 0;
+    for (const string& word : words) {
+        totalBytes += word.size() + 1;   // word plus separating comma
+    }
+    store.ownedBuffer.reserve(totalBytes);
+    store.ownedOffsets.reserve(words.size() + 1);
+
+    for (const string& word : words) {
+        store.ownedOffsets.push_back(store.ownedBuffer.size());
+        store.ownedBuffer += word;
+        store.ownedBuffer += ',';
+    }
+    store.ownedOffsets.push_back(store.ownedBuffer.size());
+    // Drop the trailing comma; the virtual-comma offset above stays valid
+    if (!store.ownedBuffer.empty()) {
+        store.ownedBuffer.pop_back();
+    }
+
+    store.buffer = store.ownedBuffer.data();
+    store.offsets = store.ownedOffsets.data();
+    store.wordCount = words.size();
+    return store;
+}
+
+// Try to serve from an existing cache file: mmap it and point the store
+// at the mapping (the mapping is kept for the life of the process).
+// Returns false if the cache is missing, stale, or malformed
+bool loadStoreCache(const string& cachePath, uint64_t sourceMtime, WordStore& store) {
+    int fd = open(cachePath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat cacheInfo;
+    if (fstat(fd, &cacheInfo) < 0 || (size_t)cacheInfo.st_size < sizeof(StoreCacheHeader)) {
+        close(fd);
+        return false;
+    }
+
+    void* mapping = mmap(NULL, cacheInfo.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+
+    const StoreCacheHeader* header = (const StoreCacheHeader*)mapping;
+    size_t expectedSize = sizeof(StoreCacheHeader)
+                        + (header->wordCount + 1) * sizeof(uint64_t)
+                        + header->bufferSize;
+    if (memcmp(header->magic, STORE_CACHE_MAGIC, 8) != 0 ||
+        header->sourceMtime != sourceMtime ||
+        (size_t)cacheInfo.st_size != expectedSize) {
+        munmap(mapping, cacheInfo.st_size);
+        return false;
+    }
+
+    store.offsets = (const uint64_t*)((const char*)mapping + sizeof(StoreCacheHeader));
+    store.buffer = (const char*)(store.offsets + header->wordCount + 1);
+    store.wordCount = header->wordCount;
+    return true;
+}
+
+// Write the freshly built store to the cache file so the next start can
+// mmap it. Written to a temp name and renamed, so a crash mid-write
+// never leaves a half cache behind. Failure only costs the speedup
+void writeStoreCache(const string& cachePath, uint64_t sourceMtime, const WordStore& store) {
+    string tempPath = cachePath + ".tmp";
+    ofstream cache(tempPath, ios::binary | ios::trunc);
+    if (!cache) {
+        cerr << "Server: Warning: cannot write store cache " << cachePath << endl;
+        return;
+    }
+
+    StoreCacheHeader header;
+    memcpy(header.magic, STORE_CACHE_MAGIC, 8);
+    header.sourceMtime = sourceMtime;
+    header.wordCount = store.wordCount;
+    header.bufferSize = store.ownedBuffer.size();
+
+    cache.write((const char*)&header, sizeof(header));
+    cache.write((const char*)store.offsets, (store.wordCount + 1) * sizeof(uint64_t));
+    cache.write(store.buffer, store.ownedBuffer.size());
+    cache.close();
+
+    if (!cache || rename(tempPath.c_str(), cachePath.c_str()) != 0) {
+        cerr << "Server: Warning: cannot write store cache " << cachePath << endl;
+        remove(tempPath.c_str());
+    }
+}
+
+// Load the word store: mmap the preprocessed cache when it matches the
+// text file's mtime, otherwise parse the text file once and regenerate
+// the cache. Startup is independent of corpus size on the cached path
+WordStore loadWordStore(const string& filename) {
+    struct stat sourceInfo;
+    if (stat(filename.c_str(), &sourceInfo) < 0) {
+        cerr << "Error opening words file: " << filename << endl;
+        exit(1);
+    }
+    uint64_t sourceMtime = (uint64_t)sourceInfo.st_mtime;
+    string cachePath = filename + ".bin";
+
+    WordStore store;
+    if (loadStoreCache(cachePath, sourceMtime, store)) {
+        cout << "Server: Loaded " << store.wordCount << " words from cache "
+             << cachePath << endl;
+        return store;
+    }
+
+    store = buildWordStore(loadWords(filename));
+    writeStoreCache(cachePath, sourceMtime, store);
+    return store;
+}
+
+// Write every byte of an iovec array, resuming after short writes
+// (large responses routinely exceed what one writev accepts)
+bool writeFully(int clientSocket, struct iovec* iov, int iovCount) {
+    while (iovCount > 0) {
+        ssize_t written = writev(clientSocket, iov, iovCount);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        // Skip past the fully-written iovecs, trim the partial one
+        while (iovCount > 0 && (size_t)written >= iov[0].iov_len) {
+            written -= iov[0].iov_len;
+            iov++;
+            iovCount--;
+        }
+        if (iovCount > 0) {
+            iov[0].iov_base = (char*)iov[0].iov_base + written;
+            iov[0].iov_len -= written;
+        }
+    }
+    return true;
+}
+
+// Answer one p,k request straight from the word store: an O(1) offset
+// lookup plus one writev over the word span, the EOF marker if the file
+// ran out, and the terminating newline. Returns bytes sent, -1 on error
+ssize_t sendResponse(int clientSocket, const WordStore& store, int p, int k) {
+    static const char eofOnly[] = "EOF\n";
+    static const char eofSuffix[] = ",EOF";
+    static const char newline[] = "\n";
+
+    int totalWords = store.wordCount;
+
+    struct iovec iov[3];
+    int iovCount = 0;
+
     // If offset is beyond file size, return EOF
     if (p >= totalWords) {
-        response = "EOF\n";
-        return response;
+        iov[iovCount].iov_base = (void*)eofOnly;
+        iov[iovCount].iov_len = 4;
+        iovCount++;
+    } else {
+        int end = p + k < totalWords ? p + k : totalWords;
+        if (end > p) {   // k == 0 asks for an empty span
+            iov[iovCount].iov_base = (void*)(store.buffer + store.offsets[p]);
+            iov[iovCount].iov_len = store.offsets[end] - 1 - store.offsets[p];
+            iovCount++;
+        }
+
+        // If we've sent fewer than k words, add EOF
+        if (end - p < k) {
+            iov[iovCount].iov_base = (void*)eofSuffix;
+            iov[iovCount].iov_len = 4;
+            iovCount++;
+        }
+
+        iov[iovCount].iov_base = (void*)newline;
+        iov[iovCount].iov_len = 1;
+        iovCount++;
     }
-    
-    // Add words starting from position p
-    int wordsAdded = 0;
-    for (int i = p; i < totalWords && wordsAdded < k; i++) {
-        if (wordsAdded > 0) {
-            response += ",";
+
+    ssize_t totalBytes = 0;
+    for (int i = 0; i < iovCount; i++) {
+        totalBytes += iov[i].iov_len;
+    }
+    return writeFully(clientSocket, iov, iovCount) ? totalBytes : -1;
+}
+
+// One connected client: its socket plus any bytes received beyond the
+// last complete request (a pipelined batch can end mid-request). The
+// context lives from accept until the client disconnects
+struct ClientContext {
+    int socket;
+    string address;
+    string pending;
+};
+
+// Fixed-size pool of worker threads draining a queue of ready client
+// sockets, so the epoll loop never blocks on a slow client. After a
+// worker has answered every complete request in the buffer it re-arms
+// the connection in epoll, so a keep-alive client costs nothing
+// between requests
+class WorkerPool {
+public:
+    WorkerPool(size_t threadCount, const WordStore& store, int epollFd)
+        : stopping(false), epollFd(epollFd) {
+        for (size_t i = 0; i < threadCount; i++) {
+            threads.emplace_back([this, &store]() {
+                while (true) {
+                    ClientContext* context;
+                    {
+                        unique_lock<mutex> lock(queueMutex);
+                        queueCondition.wait(lock, [this]() {
+                            return stopping || !tasks.empty();
+                        });
+                        if (stopping && tasks.empty()) {
+                            return;
+                        }
+                        context = tasks.front();
+                        tasks.pop();
+                    }
+                    if (handleClient(context, store)) {
+                        rearm(context);
+                    } else {
+                        delete context;
+                    }
+                }
+            });
         }
-        response += words[i];
-        wordsAdded++;
     }
-    
-    // If we've sent fewer than k words, add EOF
-    if (wordsAdded < k) {
-        if (wordsAdded > 0) {
-            response += ",";
+
+    // Hand a ready client connection to the next free worker
+    void enqueue(ClientContext* context) {
+        {
+            lock_guard<mutex> lock(queueMutex);
+            tasks.push(context);
         }
-        response += "EOF";
+        queueCondition.notify_one();
     }
-    
-    response += "\n";
-    return response;
-}
 
-// Handle a single client connection
-void handleClient(int clientSocket, const vector<string>& words, const string& clientAddr) {
-    cout << "Server: New connection from " << clientAddr << endl;
-    
+    // Finish the queued work and join every worker
+    void shutdown() {
+        {
+            lock_guard<mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueCondition.notify_all();
+        for (thread& t : threads) {
+            t.join();
+        }
+    }
+
+private:
+    static bool handleClient(ClientContext* context, const WordStore& store);
+
+    // Put the connection back under epoll's watch for its next request
+    void rearm(ClientContext* context) {
+        struct epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN | EPOLLONESHOT;
+        event.data.ptr = context;
+        if (epoll_ctl(epollFd, EPOLL_CTL_MOD, context->socket, &event) < 0) {
+            cerr << "Server: Error re-arming client socket: " << strerror(errno) << endl;
+            close(context->socket);
+            delete context;
+        }
+    }
+
+    vector<thread> threads;
+    queue<ClientContext*> tasks;
+    mutex queueMutex;
+    condition_variable queueCondition;
+    bool stopping;
+    int epollFd;
+};
+
+// Answer every complete request currently readable on a connection.
+// Requests are newline-delimited and the connection stays open until
+// the client closes it, so one client can send many (even pipelined)
+// requests without paying connection setup each time. Returns true
+// while the connection is still open
+bool WorkerPool::handleClient(ClientContext* context, const WordStore& store) {
     char buffer[1024];
-    memset(buffer, 0, sizeof(buffer));
-    
-    // Receive request
-    int bytesReceived = recv(clientSocket, buffer, sizeof(buffer) - 1, 0);
+
+    // Receive whatever has arrived; epoll said the socket is readable
+    int bytesReceived = recv(context->socket, buffer, sizeof(buffer), 0);
     if (bytesReceived <= 0) {
-        cout << "Server: Client disconnected or error receiving data" << endl;
-        close(clientSocket);
-        return;
+        close(context->socket);
+        cout << "Server: Connection closed by " << context->address << endl;
+        return false;
     }
-    
-    string request(buffer);
-    cout << "Server: Received request: " << request;
-    
-    try {
-        // Parse request
-        pair<int, int> params = parseRequest(request);
-        int p = params.first;
-        int k = params.second;
-        
-        cout << "Server: Parsed request - offset: " << p << ", count: " << k << endl;
-        
-        // Build and send response
-        string response = buildResponse(words, p, k);
-        
-        int bytesSent = send(clientSocket, response.c_str(), response.length(), 0);
-        if (bytesSent < 0) {
-            cerr << "Server: Error sending response" << endl;
-        } else {
-            cout << "Server: Sent " << bytesSent << " bytes" << endl;
+    context->pending.append(buffer, bytesReceived);
+
+    // Bounded memory per connection: a peer that streams bytes without
+    // ever sending a newline is not speaking the protocol — drop it
+    // rather than buffer without limit
+    static const size_t MAX_PENDING_REQUEST_BYTES = 65536;
+    if (context->pending.size() > MAX_PENDING_REQUEST_BYTES &&
+        context->pending.find('\n') == string::npos) {
+        cerr << "Server: Dropping " << context->address
+             << ": request exceeds " << MAX_PENDING_REQUEST_BYTES << " bytes" << endl;
+        close(context->socket);
+        return false;
+    }
+
+    // Answer every complete request in the buffer; a trailing partial
+    // request stays in the context until the rest of it arrives
+    size_t newlinePos;
+    while ((newlinePos = context->pending.find('\n')) != string::npos) {
+        string request = context->pending.substr(0, newlinePos + 1);
+        context->pending.erase(0, newlinePos + 1);
+
+        cout << "Server: Received request: " << request;
+
+        try {
+            // Parse request
+            pair<int, int> params = parseRequest(request);
+            int p = params.first;
+            int k = params.second;
+
+            cout << "Server: Parsed request - offset: " << p << ", count: " << k << endl;
+
+            // Send the word span straight from the store
+            ssize_t bytesSent = sendResponse(context->socket, store, p, k);
+            if (bytesSent < 0) {
+                cerr << "Server: Error sending response" << endl;
+            } else {
+                cout << "Server: Sent " << bytesSent << " bytes" << endl;
+            }
+
+        } catch (const exception& e) {
+            cerr << "Server: Error handling request: " << e.what() << endl;
+            string errorResponse = "ERROR\n";
+            send(context->socket, errorResponse.c_str(), errorResponse.length(), 0);
         }
-        
-    } catch (const exception& e) {
-        cerr << "Server: Error handling request: " << e.what() << endl;
-        string errorResponse = "ERROR\n";
-        send(clientSocket, errorResponse.c_str(), errorResponse.length(), 0);
     }
-    
-    // Close connection
-    close(clientSocket);
-    cout << "Server: Connection closed" << endl;
+
+    return true;
 }
 
 int main() {
@@ -202,8 +502,8 @@ int main() {
     // Parse config
     Config config = parseConfig("config.json");
     
-    // Load words from file
-    vector<string> words = loadWords(config.filename);
+    // Load the contiguous word store (mmap'd cache when fresh)
+    WordStore store = loadWordStore(config.filename);
     
     // Create socket
     int serverSocket = socket(AF_INET, SOCK_STREAM, 0);
@@ -239,57 +539,110 @@ int main() {
         exit(1);
     }
     
-    // Listen for connections
-    if (listen(serverSocket, 10) < 0) {
+    // Listen for connections (deep backlog: bursts of clients arrive together)
+    if (listen(serverSocket, 128) < 0) {
         cerr << "Error listening on socket: " << strerror(errno) << endl;
         exit(1);
     }
-    
-    cout << "Server: Listening on " << config.server_ip << ":" << config.server_port << endl;
+
+    // Non-blocking so the epoll loop can drain every pending accept
+    if (fcntl(serverSocket, F_SETFL, fcntl(serverSocket, F_GETFL, 0) | O_NONBLOCK) < 0) {
+        cerr << "Error setting non-blocking mode: " << strerror(errno) << endl;
+        exit(1);
+    }
+
+    // Create the epoll instance watching the listening socket and every
+    // connected client; a client is handed to the worker pool only once
+    // its request has actually arrived, so slow clients never tie up a
+    // worker thread
+    int epollFd = epoll_create1(0);
+    if (epollFd < 0) {
+        cerr << "Error creating epoll instance: " << strerror(errno) << endl;
+        exit(1);
+    }
+
+    struct epoll_event listenEvent;
+    memset(&listenEvent, 0, sizeof(listenEvent));
+    listenEvent.events = EPOLLIN;
+    listenEvent.data.ptr = NULL;   // NULL marks the listening socket
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, serverSocket, &listenEvent) < 0) {
+        cerr << "Error adding listening socket to epoll: " << strerror(errno) << endl;
+        exit(1);
+    }
+
+    // One worker per core, at least 4 so a few slow requests cannot
+    // stall the rest
+    size_t workerCount = thread::hardware_concurrency();
+    if (workerCount < 4) workerCount = 4;
+    WorkerPool pool(workerCount, store, epollFd);
+
+    cout << "Server: Listening on " << config.server_ip << ":" << config.server_port
+         << " with " << workerCount << " worker threads" << endl;
     cout << "Server: Press Ctrl+C to stop" << endl;
-    
-    // Accept connections
+
+    const int MAX_EVENTS = 64;
+    struct epoll_event events[MAX_EVENTS];
+
     while (keepRunning) {
-        struct sockaddr_in clientAddr;
-        socklen_t clientLen = sizeof(clientAddr);
-        
-        // Set timeout for accept to allow periodic checking of keepRunning
-        struct timeval timeout;
-        timeout.tv_sec = 1;
-        timeout.tv_usec = 0;
-        
-        fd_set readfds;
-        FD_ZERO(&readfds);
-        FD_SET(serverSocket, &readfds);
-        
-        int activity = select(serverSocket + 1, &readfds, NULL, NULL, &timeout);
-        
-        if (activity < 0 && errno != EINTR) {
-            cerr << "Select error" << endl;
+        // 1 second timeout to allow periodic checking of keepRunning
+        int eventCount = epoll_wait(epollFd, events, MAX_EVENTS, 1000);
+
+        if (eventCount < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            cerr << "epoll_wait error: " << strerror(errno) << endl;
             break;
         }
-        
-        if (activity > 0 && FD_ISSET(serverSocket, &readfds)) {
-            int clientSocket = accept(serverSocket, (struct sockaddr*)&clientAddr, &clientLen);
-            if (clientSocket < 0) {
-                if (errno != EINTR) {
-                    cerr << "Error accepting connection: " << strerror(errno) << endl;
+
+        for (int i = 0; i < eventCount; i++) {
+            if (events[i].data.ptr == NULL) {
+                // Listening socket: accept every pending connection
+                while (true) {
+                    struct sockaddr_in clientAddr;
+                    socklen_t clientLen = sizeof(clientAddr);
+                    int clientSocket = accept(serverSocket, (struct sockaddr*)&clientAddr, &clientLen);
+                    if (clientSocket < 0) {
+                        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                            cerr << "Error accepting connection: " << strerror(errno) << endl;
+                        }
+                        break;
+                    }
+
+                    // Get client IP address
+                    char clientIP[INET_ADDRSTRLEN];
+                    inet_ntop(AF_INET, &clientAddr.sin_addr, clientIP, sizeof(clientIP));
+                    string clientAddrStr = string(clientIP) + ":" + to_string(ntohs(clientAddr.sin_port));
+
+                    cout << "Server: New connection from " << clientAddrStr << endl;
+
+                    // Watch the connection for incoming requests.
+                    // EPOLLONESHOT: each readiness event fires once, so
+                    // the fd is owned by exactly one worker until that
+                    // worker re-arms it
+                    ClientContext* context = new ClientContext{clientSocket, clientAddrStr, ""};
+                    struct epoll_event clientEvent;
+                    memset(&clientEvent, 0, sizeof(clientEvent));
+                    clientEvent.events = EPOLLIN | EPOLLONESHOT;
+                    clientEvent.data.ptr = context;
+                    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, clientSocket, &clientEvent) < 0) {
+                        cerr << "Error adding client socket to epoll: " << strerror(errno) << endl;
+                        close(clientSocket);
+                        delete context;
+                    }
                 }
-                continue;
+            } else {
+                // Client socket has data (or hung up): hand it to a
+                // worker; EPOLLONESHOT already disarmed it
+                pool.enqueue((ClientContext*)events[i].data.ptr);
             }
-            
-            // Get client IP address
-            char clientIP[INET_ADDRSTRLEN];
-            inet_ntop(AF_INET, &clientAddr.sin_addr, clientIP, sizeof(clientIP));
-            string clientAddrStr = string(clientIP) + ":" + to_string(ntohs(clientAddr.sin_port));
-            
-            // Handle client
-            handleClient(clientSocket, words, clientAddrStr);
         }
     }
-    
+
+    pool.shutdown();
+    close(epollFd);
     close(serverSocket);
     cout << "\nServer: Shutting down gracefully" << endl;
-    
+
     return 0;
 }
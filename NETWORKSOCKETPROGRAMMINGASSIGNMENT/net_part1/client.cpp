@@ -9,12 +9,75 @@
 #include <map>
 #include <chrono>
 #include <cstring>
+#include <cstdint>
+#include <thread>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <nlohmann/json.hpp>
 
+// HDR-style log-linear latency histogram over microsecond values:
+// power-of-two ranges split into 32 linear sub-buckets (~3% relative
+// error), fixed memory, O(1) record, so recording never perturbs the
+// measurement. Values above the last bucket saturate into it
+class LatencyHistogram {
+private:
+    static const int BUCKETS = 44;       // covers up to ~2^48 us
+    static const int SUB_BUCKETS = 32;
+
+    std::vector<uint64_t> counts;
+    uint64_t total_count = 0;
+    uint64_t max_value = 0;
+
+    static size_t indexFor(uint64_t us) {
+        if (us < SUB_BUCKETS) return (size_t)us;
+        int bucket = 63 - __builtin_clzll(us) - 4;   // so 32..63 land in bucket 1
+        if (bucket >= BUCKETS) bucket = BUCKETS - 1;
+        return (size_t)bucket * SUB_BUCKETS + (size_t)(us >> bucket);
+    }
+
+    static uint64_t valueAt(size_t index) {
+        uint64_t bucket = index / SUB_BUCKETS;
+        uint64_t sub = index % SUB_BUCKETS;
+        if (bucket == 0) return sub;
+        // Midpoint of the sub-bucket's value range
+        return (sub << bucket) + (1ULL << (bucket - 1));
+    }
+
+public:
+    LatencyHistogram() : counts(BUCKETS * SUB_BUCKETS, 0) {}
+
+    void record(uint64_t us) {
+        counts[indexFor(us)]++;
+        total_count++;
+        if (us > max_value) max_value = us;
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < counts.size(); ++i) counts[i] += other.counts[i];
+        total_count += other.total_count;
+        if (other.max_value > max_value) max_value = other.max_value;
+    }
+
+    uint64_t count() const { return total_count; }
+
+    // Value (microseconds) at quantile q in [0, 1]
+    uint64_t percentile(double q) const {
+        if (total_count == 0) return 0;
+        uint64_t target = (uint64_t)(q * total_count + 0.5);
+        if (target < 1) target = 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts.size(); ++i) {
+            seen += counts[i];
+            if (seen >= target) return valueAt(i);
+        }
+        return max_value;
+    }
+
+    uint64_t max() const { return max_value; }
+};
+
 class WordClient {
 private:
     std::string server_ip;
@@ -47,11 +110,16 @@ private:
         }
     }
 
-    std::vector<std::string> requestWords(int offset, int count) {
-        int sock = socket(AF_INET, SOCK_STREAM, 0);
+    // One persistent connection for the whole download; -1 while closed
+    int sock = -1;
+    // Bytes received past the last complete response line
+    std::string recv_buffer;
+
+    bool connectToServer() {
+        sock = socket(AF_INET, SOCK_STREAM, 0);
         if (sock < 0) {
             std::cerr << "Socket creation error" << std::endl;
-            return {};
+            return false;
         }
 
         struct sockaddr_in serv_addr;
@@ -62,35 +130,67 @@ private:
         if (inet_pton(AF_INET, server_ip.c_str(), &serv_addr.sin_addr) <= 0) {
             std::cerr << "Invalid address/ Address not supported: " << server_ip << std::endl;
             close(sock);
-            return {};
+            sock = -1;
+            return false;
         }
 
         if (connect(sock, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) < 0) {
             std::cerr << "Connection Failed to " << server_ip << ":" << server_port << " (" << strerror(errno) << ")" << std::endl;
             close(sock);
-            return {};
+            sock = -1;
+            return false;
+        }
+
+        recv_buffer.clear();
+        return true;
+    }
+
+    void disconnect() {
+        if (sock >= 0) {
+            close(sock);
+            sock = -1;
         }
+    }
 
+    void sendRequest(int offset, int count) {
         std::string request = std::to_string(offset) + "," + std::to_string(count) + "\n";
         send(sock, request.c_str(), request.length(), 0);
+    }
 
-        char buffer[8192];
-        ssize_t valread = read(sock, buffer, sizeof(buffer) - 1);
-        close(sock);
-        if (valread <= 0) return {};
+    // Read one newline-terminated response from the persistent
+    // connection; later pipelined responses arriving in the same read
+    // stay buffered for the next call
+    bool readResponse(std::string& response) {
+        size_t newline_pos;
+        while ((newline_pos = recv_buffer.find('\n')) == std::string::npos) {
+            char buffer[8192];
+            ssize_t valread = read(sock, buffer, sizeof(buffer));
+            if (valread <= 0) return false;
+            recv_buffer.append(buffer, valread);
+        }
 
-        buffer[valread] = '\0';
-        std::string response(buffer);
-        // Trim newline(s)
-        while (!response.empty() && (response.back() == '\n' || response.back() == '\r')) response.pop_back();
+        response = recv_buffer.substr(0, newline_pos);
+        recv_buffer.erase(0, newline_pos + 1);
+        // Trim trailing carriage return
+        while (!response.empty() && response.back() == '\r') response.pop_back();
+        return true;
+    }
 
-        if (response == "EOF") return {};
+    // Split one response line into words, stopping at the EOF marker
+    std::vector<std::string> parseWords(const std::string& response, bool& reached_eof) {
+        if (response == "EOF") {
+            reached_eof = true;
+            return {};
+        }
 
         std::vector<std::string> res;
         std::stringstream ss(response);
         std::string token;
         while (std::getline(ss, token, ',')) {
-            if (token == "EOF") break;
+            if (token == "EOF") {
+                reached_eof = true;
+                break;
+            }
             res.push_back(token);
         }
         return res;
@@ -116,22 +216,43 @@ public:
         auto start_time = std::chrono::high_resolution_clock::now();
 
         std::map<std::string, int> word_frequencies;
-        int current_offset = p;
 
-        while (true) {
-            std::vector<std::string> words = requestWords(current_offset, k);
+        // One persistent connection carries every request; the next
+        // request is pipelined onto the wire before the current response
+        // is read, so each page costs well under a full round trip and
+        // no connection setup
+        if (!connectToServer()) return;
 
-            if (words.empty()) break;
+        int next_offset = p;
+        int in_flight = 0;
+        bool reached_eof = false;
 
-            for (const auto& w : words) {
-                word_frequencies[w]++;
+        sendRequest(next_offset, k);
+        next_offset += k;
+        in_flight++;
+
+        while (in_flight > 0) {
+            // The server returns exactly k words until EOF, so the next
+            // offset is known before the current response arrives
+            if (!reached_eof) {
+                sendRequest(next_offset, k);
+                next_offset += k;
+                in_flight++;
             }
 
-            current_offset += (int)words.size();
+            std::string response;
+            if (!readResponse(response)) break;
+            in_flight--;
 
-            if ((int)words.size() < k) break;
+            std::vector<std::string> words = parseWords(response, reached_eof);
+
+            for (const auto& w : words) {
+                word_frequencies[w]++;
+            }
         }
 
+        disconnect();
+
         auto end_time = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
@@ -140,12 +261,149 @@ public:
         // Print elapsed time in a parse-friendly format
         std::cout << "ELAPSED_MS:" << duration.count() << std::endl;
     }
+
+    // Benchmark mode: `connections` threads each drive one persistent
+    // connection for `duration_s` seconds, paging through the corpus
+    // with the configured k and recording per-request latency into an
+    // HDR-style histogram. With a target rate, requests are paced on a
+    // fixed schedule and latency is measured from the *intended* send
+    // time, so a stalled server cannot hide queueing delay by slowing
+    // the request stream down (coordinated omission). rate 0 = closed
+    // loop at full speed. Returns nonzero if nothing completed
+    int runBenchmark(int connections, double rate, int duration_s,
+                     const std::string& csv_path) {
+        std::vector<LatencyHistogram> histograms(connections);
+        std::vector<uint64_t> errors(connections, 0);
+        std::vector<std::thread> threads;
+
+        auto bench_start = std::chrono::steady_clock::now();
+        auto bench_end = bench_start + std::chrono::seconds(duration_s);
+
+        for (int t = 0; t < connections; ++t) {
+            threads.emplace_back([this, t, connections, rate, bench_start,
+                                  bench_end, &histograms, &errors]() {
+                // Private copy: own socket and receive buffer, shared
+                // nothing with the other workers
+                WordClient worker = *this;
+                worker.sock = -1;
+                worker.recv_buffer.clear();
+
+                // Per-thread share of the target rate
+                std::chrono::nanoseconds interval(0);
+                if (rate > 0) {
+                    interval = std::chrono::nanoseconds(
+                        (uint64_t)(1e9 * connections / rate));
+                }
+                auto next_send = bench_start;
+
+                int offset = worker.p;
+                while (std::chrono::steady_clock::now() < bench_end) {
+                    if (worker.sock < 0) {
+                        if (!worker.connectToServer()) {
+                            errors[t]++;
+                            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                            continue;
+                        }
+                        // A connection the server never services must
+                        // not hang the worker past the benchmark end
+                        struct timeval timeout;
+                        timeout.tv_sec = 2;
+                        timeout.tv_usec = 0;
+                        setsockopt(worker.sock, SOL_SOCKET, SO_RCVTIMEO,
+                                   &timeout, sizeof(timeout));
+                    }
+
+                    auto now = std::chrono::steady_clock::now();
+                    auto issue_time = now;
+                    if (rate > 0) {
+                        // Paced: wait for the schedule, measure from it
+                        if (next_send > now) {
+                            std::this_thread::sleep_until(next_send);
+                        }
+                        issue_time = next_send;
+                        next_send += interval;
+                    }
+
+                    worker.sendRequest(offset, worker.k);
+                    std::string response;
+                    if (!worker.readResponse(response)) {
+                        errors[t]++;
+                        worker.disconnect();
+                        continue;
+                    }
+
+                    auto done = std::chrono::steady_clock::now();
+                    histograms[t].record(
+                        std::chrono::duration_cast<std::chrono::microseconds>(
+                            done - issue_time).count());
+
+                    // Page onward; wrap to the start once the file ends
+                    bool reached_eof = false;
+                    worker.parseWords(response, reached_eof);
+                    offset = reached_eof ? worker.p : offset + worker.k;
+                }
+                worker.disconnect();
+            });
+        }
+        for (auto& t : threads) t.join();
+        auto actual_end = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double>(actual_end - bench_start).count();
+
+        LatencyHistogram histogram;
+        uint64_t total_errors = 0;
+        for (int t = 0; t < connections; ++t) {
+            histogram.merge(histograms[t]);
+            total_errors += errors[t];
+        }
+
+        double throughput = elapsed > 0 ? histogram.count() / elapsed : 0;
+        std::cout << "Benchmark: " << connections << " connections, target rate ";
+        if (rate > 0) std::cout << rate << " req/s";
+        else std::cout << "unlimited";
+        std::cout << ", " << duration_s << "s, k=" << k << std::endl;
+        std::cout << "Requests: " << histogram.count() << " ("
+                  << throughput << " req/s), errors: " << total_errors << std::endl;
+        std::cout << "Latency (ms): p50 " << histogram.percentile(0.50) / 1000.0
+                  << "  p95 " << histogram.percentile(0.95) / 1000.0
+                  << "  p99 " << histogram.percentile(0.99) / 1000.0
+                  << "  p99.9 " << histogram.percentile(0.999) / 1000.0
+                  << "  max " << histogram.max() / 1000.0 << std::endl;
+
+        if (!csv_path.empty()) {
+            bool write_header = true;
+            {
+                std::ifstream existing(csv_path);
+                write_header = !existing || existing.peek() == EOF;
+            }
+            std::ofstream csv(csv_path, std::ios::app);
+            if (!csv) {
+                std::cerr << "Error: cannot write CSV file " << csv_path << std::endl;
+            } else {
+                if (write_header) {
+                    csv << "connections,target_rate,duration_s,k,requests,errors,"
+                           "throughput_rps,p50_us,p95_us,p99_us,p999_us,max_us\n";
+                }
+                csv << connections << "," << rate << "," << duration_s << ","
+                    << k << "," << histogram.count() << "," << total_errors << ","
+                    << throughput << "," << histogram.percentile(0.50) << ","
+                    << histogram.percentile(0.95) << "," << histogram.percentile(0.99) << ","
+                    << histogram.percentile(0.999) << "," << histogram.max() << "\n";
+            }
+        }
+
+        return histogram.count() > 0 ? 0 : 1;
+    }
 };
 
 int main(int argc, char* argv[]) {
     std::string config_file = "config.json";
     bool quiet_mode = false;
     int override_k = -1;
+    bool bench_mode = false;
+    int bench_connections = 8;
+    double bench_rate = 0;        // 0 = unthrottled closed loop
+    int bench_duration = 10;
+    std::string bench_csv;
 
     for (int i = 1; i < argc; ++i) {
         std::string a = argv[i];
@@ -155,12 +413,26 @@ int main(int argc, char* argv[]) {
             quiet_mode = true;
         } else if (a == "--k" && i + 1 < argc) {
             override_k = std::stoi(argv[++i]);
+        } else if (a == "--bench") {
+            bench_mode = true;
+        } else if (a == "--connections" && i + 1 < argc) {
+            bench_connections = std::stoi(argv[++i]);
+        } else if (a == "--rate" && i + 1 < argc) {
+            bench_rate = std::stod(argv[++i]);
+        } else if (a == "--duration" && i + 1 < argc) {
+            bench_duration = std::stoi(argv[++i]);
+        } else if (a == "--csv" && i + 1 < argc) {
+            bench_csv = argv[++i];
         }
     }
 
     try {
         WordClient client(config_file, quiet_mode);
         if (override_k > 0) client.setK(override_k);
+        if (bench_mode) {
+            return client.runBenchmark(bench_connections, bench_rate,
+                                       bench_duration, bench_csv);
+        }
         client.run();
     } catch (const std::exception& e) {
         std::cerr << "Client error: " << e.what() << std::endl;
@@ -9,15 +9,45 @@
 #include <algorithm>
 #include <cstring>
 #include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
 #include <netinet/in.h>
 #include <unistd.h>
 #include <arpa/inet.h>
 #include <nlohmann/json.hpp>
 
+// On-disk layout of the preprocessed word store (<words file>.bin):
+// this header, then word_count+1 offsets, then the joined word buffer.
+// source_mtime ties the cache to the text file it was compiled from
+struct StoreCacheHeader {
+    char magic[8];                    // "NPWORDS1"
+    uint64_t source_mtime;
+    uint64_t word_count;
+    uint64_t buffer_size;
+};
+
+static const char STORE_CACHE_MAGIC[8] = {'N', 'P', 'W', 'O', 'R', 'D', 'S', '1'};
+
 class WordServer {
 private:
-    std::vector<std::string> words;
+    // Contiguous word store: all words joined by commas plus a prefix
+    // array of byte offsets, so the words of any p,k request are one
+    // contiguous span and responses need no string assembly. Either
+    // owned (built fresh from the text file) or views into the mmap'd
+    // preprocessed cache
+    std::string owned_buffer;
+    std::vector<uint64_t> owned_offsets;
+    const char* word_buffer = nullptr;   // "w0,w1,...,wn-1"
+    const uint64_t* word_offsets = nullptr; // start of word i; one extra
+                                      // entry one past a virtual trailing
+                                      // comma after the last word
+    uint64_t word_count = 0;
     int server_fd = -1;
     struct sockaddr_in address;
     std::string filename;
@@ -32,13 +62,90 @@ private:
         return s.substr(start, end - start + 1);
     }
 
+    // Try to serve from an existing preprocessed cache: mmap it and
+    // point the store at the mapping (kept for the life of the process).
+    // Returns false if the cache is missing, stale, or malformed
+    bool loadStoreCache(const std::string& cache_path, uint64_t source_mtime) {
+        int fd = open(cache_path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat cache_info;
+        if (fstat(fd, &cache_info) < 0 || (size_t)cache_info.st_size < sizeof(StoreCacheHeader)) {
+            close(fd);
+            return false;
+        }
+
+        void* mapping = mmap(nullptr, cache_info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) return false;
+
+        const auto* header = (const StoreCacheHeader*)mapping;
+        size_t expected_size = sizeof(StoreCacheHeader)
+                             + (header->word_count + 1) * sizeof(uint64_t)
+                             + header->buffer_size;
+        if (std::memcmp(header->magic, STORE_CACHE_MAGIC, 8) != 0 ||
+            header->source_mtime != source_mtime ||
+            (size_t)cache_info.st_size != expected_size) {
+            munmap(mapping, cache_info.st_size);
+            return false;
+        }
+
+        word_offsets = (const uint64_t*)((const char*)mapping + sizeof(StoreCacheHeader));
+        word_buffer = (const char*)(word_offsets + header->word_count + 1);
+        word_count = header->word_count;
+        return true;
+    }
+
+    // Write the freshly built store so the next start can mmap it;
+    // temp-file-and-rename so a crash never leaves a half cache behind
+    void writeStoreCache(const std::string& cache_path, uint64_t source_mtime) {
+        std::string temp_path = cache_path + ".tmp";
+        std::ofstream cache(temp_path, std::ios::binary | std::ios::trunc);
+        if (!cache) {
+            std::cerr << "Warning: cannot write store cache " << cache_path << std::endl;
+            return;
+        }
+
+        StoreCacheHeader header;
+        std::memcpy(header.magic, STORE_CACHE_MAGIC, 8);
+        header.source_mtime = source_mtime;
+        header.word_count = word_count;
+        header.buffer_size = owned_buffer.size();
+
+        cache.write((const char*)&header, sizeof(header));
+        cache.write((const char*)word_offsets, (word_count + 1) * sizeof(uint64_t));
+        cache.write(word_buffer, owned_buffer.size());
+        cache.close();
+
+        if (!cache || std::rename(temp_path.c_str(), cache_path.c_str()) != 0) {
+            std::cerr << "Warning: cannot write store cache " << cache_path << std::endl;
+            std::remove(temp_path.c_str());
+        }
+    }
+
     void loadWords() {
+        struct stat source_info;
+        if (stat(filename.c_str(), &source_info) < 0) {
+            std::cerr << "Error: Cannot open file " << filename << std::endl;
+            exit(1);
+        }
+        uint64_t source_mtime = (uint64_t)source_info.st_mtime;
+        std::string cache_path = filename + ".bin";
+
+        // Fast path: mmap the preprocessed store and serve immediately
+        if (loadStoreCache(cache_path, source_mtime)) {
+            std::cout << "Loaded " << word_count << " words from cache "
+                      << cache_path << std::endl;
+            return;
+        }
+
         std::ifstream file(filename);
         if (!file.is_open()) {
             std::cerr << "Error: Cannot open file " << filename << std::endl;
             exit(1);
         }
 
+        std::vector<std::string> words;
         std::string line;
         // Read entire file as single comma-separated line(s)
         std::string content;
@@ -55,6 +162,27 @@ private:
             if (!t.empty()) words.push_back(t);
         }
         std::cout << "Loaded " << words.size() << " words from " << filename << std::endl;
+
+        // Build the contiguous store the request path serves from
+        size_t total_bytes = 0;
+        for (const auto& w : words) total_bytes += w.size() + 1;
+        owned_buffer.reserve(total_bytes);
+        owned_offsets.reserve(words.size() + 1);
+        for (const auto& w : words) {
+            owned_offsets.push_back(owned_buffer.size());
+            owned_buffer += w;
+            owned_buffer += ',';
+        }
+        owned_offsets.push_back(owned_buffer.size());
+        // Drop the trailing comma; the extra offset entry stays valid
+        if (!owned_buffer.empty()) owned_buffer.pop_back();
+
+        word_buffer = owned_buffer.data();
+        word_offsets = owned_offsets.data();
+        word_count = words.size();
+
+        // Regenerate the cache for the next (instant) start
+        writeStoreCache(cache_path, source_mtime);
     }
 
     void loadConfig(const std::string& config_file) {
@@ -76,24 +204,23 @@ private:
         std::cout << "Server config: IP=" << server_ip << ", Port=" << port << ", File=" << filename << std::endl;
     }
 
-public:
-    WordServer(const std::string& config_file) {
-        loadConfig(config_file);
-        loadWords();
-
-        // Create socket
-        if ((server_fd = socket(AF_INET, SOCK_STREAM, 0)) < 0) {
+    // Create one listening socket on the configured address. Every
+    // shard binds its own socket with SO_REUSEPORT, and the kernel
+    // load-balances incoming connections across them
+    int createListenSocket() {
+        int fd;
+        if ((fd = socket(AF_INET, SOCK_STREAM, 0)) < 0) {
             perror("socket failed");
             exit(1);
         }
 
         // Allow rebind
         int opt = 1;
-        if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
+        if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
             perror("setsockopt(SO_REUSEADDR) failed");
         }
 #ifdef SO_REUSEPORT
-        if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+        if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
             perror("setsockopt(SO_REUSEPORT) failed");
         }
 #endif
@@ -112,93 +239,174 @@ public:
             }
         }
 
-        if (bind(server_fd, (struct sockaddr *)&address, sizeof(address)) < 0) {
+        if (bind(fd, (struct sockaddr *)&address, sizeof(address)) < 0) {
             perror("bind failed");
-            close(server_fd);
+            close(fd);
             exit(1);
         }
 
-        if (listen(server_fd, 10) < 0) {
+        if (listen(fd, 10) < 0) {
             perror("listen");
-            close(server_fd);
+            close(fd);
             exit(1);
         }
 
-        std::cout << "Server listening on " << server_ip << ":" << port << std::endl;
+        return fd;
     }
 
-    std::string handleRequest(int offset, int k) {
-        std::stringstream response;
+public:
+    WordServer(const std::string& config_file) {
+        loadConfig(config_file);
+        loadWords();
+
+        server_fd = createListenSocket();
+        std::cout << "Server listening on " << server_ip << ":" << port << std::endl;
+    }
 
-        if (offset >= (int)words.size()) {
-            response << "EOF\n";
-            return response.str();
+    // Write every byte of an iovec array, resuming after short writes
+    static bool writeFully(int fd, struct iovec* iov, int iov_count) {
+        while (iov_count > 0) {
+            ssize_t written = writev(fd, iov, iov_count);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            while (iov_count > 0 && (size_t)written >= iov[0].iov_len) {
+                written -= iov[0].iov_len;
+                iov++;
+                iov_count--;
+            }
+            if (iov_count > 0) {
+                iov[0].iov_base = (char*)iov[0].iov_base + written;
+                iov[0].iov_len -= written;
+            }
         }
+        return true;
+    }
 
-        int end_pos = std::min(offset + k, (int)words.size());
-        bool eof_reached = (end_pos == (int)words.size() && (end_pos - offset) < k);
+    // Answer one request straight from the word store: an O(1) offset
+    // lookup plus one writev over the word span, the EOF marker when the
+    // file ran out, and the newline. Returns bytes sent, -1 on error
+    ssize_t sendResponse(int fd, int offset, int k) {
+        static const char eof_only[] = "EOF\n";
+        static const char eof_suffix[] = ",EOF";
+        static const char newline[] = "\n";
+
+        int total = (int)word_count;
+        struct iovec iov[3];
+        int iov_count = 0;
+
+        if (offset >= total) {
+            iov[iov_count].iov_base = (void*)eof_only;
+            iov[iov_count].iov_len = 4;
+            iov_count++;
+        } else {
+            int end_pos = std::min(offset + k, total);
+            bool eof_reached = (end_pos == total && (end_pos - offset) < k);
 
-        for (int i = offset; i < end_pos; i++) {
-            response << words[i];
-            if (i < end_pos - 1) response << ",";
+            if (end_pos > offset) {   // k == 0 asks for an empty span
+                iov[iov_count].iov_base = (void*)(word_buffer + word_offsets[offset]);
+                iov[iov_count].iov_len = word_offsets[end_pos] - 1 - word_offsets[offset];
+                iov_count++;
+            }
+            if (eof_reached) {
+                iov[iov_count].iov_base = (void*)eof_suffix;
+                iov[iov_count].iov_len = 4;
+                iov_count++;
+            }
+            iov[iov_count].iov_base = (void*)newline;
+            iov[iov_count].iov_len = 1;
+            iov_count++;
         }
 
-        if (eof_reached) {
-            response << ",EOF";
+        ssize_t total_bytes = 0;
+        for (int i = 0; i < iov_count; i++) total_bytes += iov[i].iov_len;
+        return writeFully(fd, iov, iov_count) ? total_bytes : -1;
+    }
+
+    // One connection's keep-alive loop: the connection carries any number
+    // of newline-delimited requests and stays open until the client closes
+    // it. A batch of pipelined requests arriving in one read is answered
+    // request by request, in order
+    void serveConnection(int new_socket) {
+        std::string pending;
+        char buffer[4096];
+        ssize_t r;
+        while ((r = read(new_socket, buffer, sizeof(buffer))) > 0) {
+            pending.append(buffer, r);
+
+            size_t newline_pos;
+            while ((newline_pos = pending.find('\n')) != std::string::npos) {
+                std::string received = pending.substr(0, newline_pos);
+                pending.erase(0, newline_pos + 1);
+                // Trim trailing carriage return
+                while (!received.empty() && received.back() == '\r') received.pop_back();
+                if (received.empty()) continue;
+
+                std::cout << "Received request: " << received << std::endl;
+
+                size_t comma_pos = received.find(',');
+                if (comma_pos != std::string::npos) {
+                    int offset = std::stoi(received.substr(0, comma_pos));
+                    int k = std::stoi(received.substr(comma_pos + 1));
+                    std::cout << "Request: offset=" << offset << ", k=" << k << std::endl;
+                    ssize_t s = sendResponse(new_socket, offset, k);
+                    if (s < 0) perror("writev");
+                    else std::cout << "Sent response (" << s << " bytes)" << std::endl;
+                } else {
+                    std::string error_response = "Error: Invalid request format\n";
+                    send(new_socket, error_response.c_str(), error_response.length(), 0);
+                }
+            }
         }
 
-        response << "\n";
-        return response.str();
+        close(new_socket);
+        std::cout << "Client disconnected\n" << std::endl;
     }
 
-    void run() {
+    // One shard's accept loop: each accepted connection gets its own
+    // detached thread, so a shard serves all of its keep-alive clients
+    // concurrently instead of one at a time (two persistent connections
+    // hashed to the same SO_REUSEPORT socket would otherwise leave one
+    // starved until the other disconnects). The word store is read-only
+    // after load, so connection threads need no synchronization
+    void serveLoop(int listen_fd, int shard_id) {
         while (true) {
             int new_socket;
-            socklen_t addrlen = sizeof(address);
+            struct sockaddr_in client_addr;
+            socklen_t addrlen = sizeof(client_addr);
 
-            std::cout << "Waiting for connection..." << std::endl;
-            if ((new_socket = accept(server_fd, (struct sockaddr *)&address, &addrlen)) < 0) {
+            std::cout << "[shard " << shard_id << "] Waiting for connection..." << std::endl;
+            if ((new_socket = accept(listen_fd, (struct sockaddr *)&client_addr, &addrlen)) < 0) {
                 perror("accept");
                 continue;
             }
             std::cout << "Client connected" << std::endl;
 
-            // Read client request
-            std::string received;
-            char buffer[4096];
-            ssize_t r;
-            // read until newline or EOF
-            r = read(new_socket, buffer, sizeof(buffer) - 1);
-            if (r <= 0) {
-                close(new_socket);
-                std::cout << "Client disconnected (no data)\n" << std::endl;
-                continue;
-            }
-            buffer[r] = '\0';
-            received = std::string(buffer);
-            // Trim trailing newline
-            if (!received.empty() && (received.back() == '\n' || received.back() == '\r')) {
-                while (!received.empty() && (received.back() == '\n' || received.back() == '\r')) received.pop_back();
-            }
+            std::thread(&WordServer::serveConnection, this, new_socket).detach();
+        }
+    }
 
-            std::cout << "Received request: " << received << std::endl;
-
-            size_t comma_pos = received.find(',');
-            if (comma_pos != std::string::npos) {
-                int offset = std::stoi(received.substr(0, comma_pos));
-                int k = std::stoi(received.substr(comma_pos + 1));
-                std::cout << "Request: offset=" << offset << ", k=" << k << std::endl;
-                std::string response = handleRequest(offset, k);
-                ssize_t s = send(new_socket, response.c_str(), response.size(), 0);
-                if (s < 0) perror("send");
-                std::cout << "Sent response: " << response;
-            } else {
-                std::string error_response = "Error: Invalid request format\n";
-                send(new_socket, error_response.c_str(), error_response.length(), 0);
-            }
+    // Serve with `shards` independent accept loops, each on its own
+    // SO_REUSEPORT listening socket, so the kernel spreads connections
+    // across cores. shards <= 1 keeps a single accept loop
+    void run(int shards = 1) {
+        if (shards <= 1) {
+            serveLoop(server_fd, 0);
+            return;
+        }
 
-            close(new_socket);
-            std::cout << "Client disconnected\n" << std::endl;
+        std::cout << "Serving with " << shards << " SO_REUSEPORT shards" << std::endl;
+        std::vector<std::thread> workers;
+        for (int shard = 0; shard < shards; ++shard) {
+            // Shard 0 reuses the socket the constructor already bound
+            int listen_fd = (shard == 0) ? server_fd : createListenSocket();
+            workers.emplace_back([this, listen_fd, shard]() {
+                serveLoop(listen_fd, shard);
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
         }
     }
 
@@ -209,16 +417,20 @@ public:
 
 int main(int argc, char* argv[]) {
     std::string config_file = "config.json";
+    int shards = 1;
     for (int i = 1; i < argc; ++i) {
         if (std::string(argv[i]) == "--config" && i + 1 < argc) {
             config_file = argv[i + 1];
             ++i;
+        } else if (std::string(argv[i]) == "--shards" && i + 1 < argc) {
+            shards = std::stoi(argv[i + 1]);
+            ++i;
         }
     }
 
     try {
         WordServer server(config_file);
-        server.run();
+        server.run(shards);
     } catch (const std::exception& e) {
         std::cerr << "Server error: " << e.what() << std::endl;
         return 1;
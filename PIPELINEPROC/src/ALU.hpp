@@ -2,95 +2,88 @@
 #define ALU_HPP
 
 #include <cstdint>
-#include <string>
+#include "MicroOp.hpp"
 
 class ALU {
 public:
-    static uint32_t execute(const std::string& operation, uint32_t operand1, uint32_t operand2) {
-        // Arithmetic operations
-        if (operation == "ADD" || operation == "ADDI") {
-            return operand1 + operand2;
+    static uint32_t execute(AluOp operation, uint32_t operand1, uint32_t operand2) {
+        switch (operation) {
+            // Arithmetic operations
+            case AluOp::ADD:
+            case AluOp::ADDI:
+                return operand1 + operand2;
+            case AluOp::SUB:
+                return operand1 - operand2;
+            // Logical operations
+            case AluOp::AND:
+            case AluOp::ANDI:
+                return operand1 & operand2;
+            case AluOp::OR:
+            case AluOp::ORI:
+                return operand1 | operand2;
+            case AluOp::XOR:
+            case AluOp::XORI:
+                return operand1 ^ operand2;
+            // Shift operations
+            case AluOp::SLL:
+            case AluOp::SLLI:
+                return operand1 << (operand2 & 0x1F);  // Shift left logical
+            case AluOp::SRL:
+            case AluOp::SRLI:
+                return operand1 >> (operand2 & 0x1F);  // Shift right logical
+            case AluOp::SRA:
+            case AluOp::SRAI:
+                return static_cast<uint32_t>(static_cast<int32_t>(operand1) >> (operand2 & 0x1F));  // Shift right arithmetic
+            // Compare operations
+            case AluOp::SLT:
+            case AluOp::SLTI:
+                return (static_cast<int32_t>(operand1) < static_cast<int32_t>(operand2)) ? 1 : 0;
+            case AluOp::SLTU:
+            case AluOp::SLTIU:
+                return (operand1 < operand2) ? 1 : 0;
+            // Branch comparisons
+            case AluOp::BEQ:
+                return (operand1 == operand2) ? 1 : 0;
+            case AluOp::BNE:
+                return (operand1 != operand2) ? 1 : 0;
+            case AluOp::BLT:
+                return (static_cast<int32_t>(operand1) < static_cast<int32_t>(operand2)) ? 1 : 0;
+            case AluOp::BGE:
+                return (static_cast<int32_t>(operand1) >= static_cast<int32_t>(operand2)) ? 1 : 0;
+            case AluOp::BLTU:
+                return (operand1 < operand2) ? 1 : 0;
+            case AluOp::BGEU:
+                return (operand1 >= operand2) ? 1 : 0;
+            // Memory and jump operations
+            case AluOp::LB:
+            case AluOp::JAL:
+            case AluOp::JALR:
+                return operand1 + operand2;  // Address calculation
+            // Default case
+            default:
+                return 0;
         }
-        else if (operation == "SUB") {
-            return operand1 - operand2;
-        }
-        // Logical operations
-        else if (operation == "AND") {
-            return operand1 & operand2;
-        }
-        else if (operation == "OR") {
-            return operand1 | operand2;
-        }
-        else if (operation == "XOR") {
-            return operand1 ^ operand2;
-        }
-        // Shift operations
-        else if (operation == "SLL") {
-            return operand1 << (operand2 & 0x1F);  // Shift left logical
-        }
-        else if (operation == "SRL") {
-            return operand1 >> (operand2 & 0x1F);  // Shift right logical
-        }
-        else if (operation == "SRA") {
-            return static_cast<uint32_t>(static_cast<int32_t>(operand1) >> (operand2 & 0x1F));  // Shift right arithmetic
-        }
-        // Compare operations
-        else if (operation == "SLT") {
-            return (static_cast<int32_t>(operand1) < static_cast<int32_t>(operand2)) ? 1 : 0;
-        }
-        else if (operation == "SLTU") {
-            return (operand1 < operand2) ? 1 : 0;
-        }
-        // Branch comparisons
-        else if (operation == "BEQ") {
-            return (operand1 == operand2) ? 1 : 0;
-        }
-        else if (operation == "BNE") {
-            return (operand1 != operand2) ? 1 : 0;
-        }
-        else if (operation == "BLT") {
-            return (static_cast<int32_t>(operand1) < static_cast<int32_t>(operand2)) ? 1 : 0;
-        }
-        else if (operation == "BGE") {
-            return (static_cast<int32_t>(operand1) >= static_cast<int32_t>(operand2)) ? 1 : 0;
-        }
-        else if (operation == "BLTU") {
-            return (operand1 < operand2) ? 1 : 0;
-        }
-        else if (operation == "BGEU") {
-            return (operand1 >= operand2) ? 1 : 0;
-        }
-        // Memory and jump operations
-        else if (operation == "LB" || operation == "JALR" || operation == "JAL") {
-            return operand1 + operand2;  // Address calculation
-        }
-
-        // Default case
-        return 0;
     }
 
     // Helper function for branch comparison
-    static bool branchCondition(const std::string& operation, uint32_t operand1, uint32_t operand2) {
-        if (operation == "BEQ") {
-            return operand1 == operand2;
-        }
-        else if (operation == "BNE") {
-            return operand1 != operand2;
-        }
-        else if (operation == "BLT") {
-            return static_cast<int32_t>(operand1) < static_cast<int32_t>(operand2);
-        }
-        else if (operation == "BGE") {
-            return static_cast<int32_t>(operand1) >= static_cast<int32_t>(operand2);
-        }
-        else if (operation == "BLTU") {
-            return operand1 < operand2;
-        }
-        else if (operation == "BGEU") {
-            return operand1 >= operand2;
+    static bool branchCondition(AluOp operation, uint32_t operand1, uint32_t operand2) {
+        switch (operation) {
+            case AluOp::BEQ:
+                return operand1 == operand2;
+            case AluOp::BNE:
+                return operand1 != operand2;
+            case AluOp::BLT:
+                return static_cast<int32_t>(operand1) < static_cast<int32_t>(operand2);
+            case AluOp::BGE:
+                return static_cast<int32_t>(operand1) >= static_cast<int32_t>(operand2);
+            case AluOp::BLTU:
+                return operand1 < operand2;
+            case AluOp::BGEU:
+                return operand1 >= operand2;
+            default:
+                return false;
         }
-        return false;
     }
 };
 
-#endif // ALU_HPP
\ No newline at end of file
+#endif // ALU_HPP
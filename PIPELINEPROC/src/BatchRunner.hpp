@@ -0,0 +1,139 @@
+#ifndef BATCHRUNNER_HPP
+#define BATCHRUNNER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Forwarding.hpp"
+
+// Batch mode for regression sweeps: takes a list file with one
+// instruction file per line, runs every program through its own
+// processor instance on a thread pool (each instance is self-contained),
+// and prints one consolidated results table. Stats-only simulation is
+// forced and the simulators' own output is silenced; results are read
+// back through lastStats().
+class BatchRunner {
+private:
+    // Discards everything written to it while the workers run
+    struct NullStreamBuffer : std::streambuf {
+        int overflow(int character) { return character; }
+    };
+
+    struct Result {
+        std::string inputFile;
+        PipelineStats stats;
+        bool failed;
+        Result() : failed(false) {}
+    };
+
+public:
+    static int run(const std::string& listFile, uint32_t cycleBudget, unsigned int jobCount) {
+        std::vector<std::string> inputFiles;
+        std::ifstream list(listFile);
+        if (!list) {
+            std::cerr << "Failed to open batch list: " << listFile << std::endl;
+            return 1;
+        }
+        std::string line;
+        while (std::getline(list, line)) {
+            if (!line.empty()) inputFiles.push_back(line);
+        }
+        if (inputFiles.empty()) {
+            std::cerr << "Batch list is empty: " << listFile << std::endl;
+            return 1;
+        }
+
+        if (jobCount == 0) {
+            jobCount = std::thread::hardware_concurrency();
+            if (jobCount == 0) jobCount = 1;
+        }
+        if (jobCount > inputFiles.size()) {
+            jobCount = (unsigned int)inputFiles.size();
+        }
+
+        std::vector<Result> results(inputFiles.size());
+        std::atomic<size_t> nextIndex(0);
+
+        // Silence the simulators for the duration of the sweep; the
+        // consolidated table below is the only output
+        NullStreamBuffer nullBuffer;
+        std::streambuf* savedBuffer = std::cout.rdbuf(&nullBuffer);
+
+        auto startTime = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (unsigned int workerId = 0; workerId < jobCount; ++workerId) {
+            workers.push_back(std::thread([&]() {
+                for (;;) {
+                    size_t index = nextIndex.fetch_add(1);
+                    if (index >= inputFiles.size()) break;
+                    Result& result = results[index];
+                    result.inputFile = inputFiles[index];
+                    // Check readability up front; the processor
+                    // constructor exits the whole process on failure
+                    std::ifstream check(inputFiles[index]);
+                    if (!check) {
+                        result.failed = true;
+                        continue;
+                    }
+                    check.close();
+                    NoForwardProcessor processor(inputFiles[index], true);
+                    processor.simulate(cycleBudget);
+                    result.stats = processor.lastStats();
+                }
+            }));
+        }
+        for (size_t i = 0; i < workers.size(); ++i) {
+            workers[i].join();
+        }
+        auto endTime = std::chrono::steady_clock::now();
+        std::cout.rdbuf(savedBuffer);
+
+        double elapsedSeconds = std::chrono::duration<double>(endTime - startTime).count();
+
+        // Consolidated results table
+        std::cout << "Batch Results (" << inputFiles.size() << " programs, "
+                  << cycleBudget << " cycles each, " << jobCount << " threads):\n";
+        uint64_t totalRetired = 0;
+        size_t failedCount = 0;
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& result = results[i];
+            std::cout << std::left << std::setw(40) << result.inputFile << std::right;
+            if (result.failed) {
+                std::cout << "  FAILED (unreadable)\n";
+                failedCount++;
+                continue;
+            }
+            totalRetired += result.stats.retired;
+            std::cout << "  retired " << std::setw(8) << result.stats.retired
+                      << "  stalls " << std::setw(8) << result.stats.stallCycles
+                      << "  CPI ";
+            if (result.stats.retired > 0) {
+                std::cout << std::fixed << std::setprecision(2)
+                          << (double)result.stats.totalCycles / result.stats.retired
+                          << std::defaultfloat << std::setprecision(6);
+            } else {
+                std::cout << "-";
+            }
+            std::cout << "\n";
+        }
+        std::cout << "Total: " << totalRetired << " instructions retired in "
+                  << std::fixed << std::setprecision(3) << elapsedSeconds
+                  << std::defaultfloat << std::setprecision(6) << "s ("
+                  << (elapsedSeconds > 0 ? (double)inputFiles.size() / elapsedSeconds : 0)
+                  << " programs/s)";
+        if (failedCount > 0) {
+            std::cout << ", " << failedCount << " failed";
+        }
+        std::cout << std::endl;
+        return failedCount > 0 ? 1 : 0;
+    }
+};
+
+#endif // BATCHRUNNER_HPP
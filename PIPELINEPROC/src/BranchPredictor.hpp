@@ -0,0 +1,101 @@
+#ifndef BRANCHPREDICTOR_HPP
+#define BRANCHPREDICTOR_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Parameterized branch predictor shared by both processors: a table of
+// 2-bit saturating counters plus a branch target buffer (BTB), both
+// indexed by pc/4 masked to a power-of-two size. The ALWAYS_STALL
+// baseline never predicts taken, which reproduces the original
+// fetch-sequential, flush-on-taken behavior exactly.
+class BranchPredictor {
+public:
+    enum class Mode { ALWAYS_STALL, TWO_BIT };
+
+private:
+    struct BtbEntry {
+        uint32_t pc;
+        uint32_t target;
+        bool valid;
+        BtbEntry() : pc(0), target(0), valid(false) {}
+    };
+
+    Mode mode;
+    uint32_t indexMask;
+    std::vector<uint8_t> counters;   // 2-bit saturating counters
+    std::vector<BtbEntry> btb;
+
+    // Statistics
+    uint64_t resolves;               // Control-flow instructions resolved
+    uint64_t correct;
+    uint64_t mispredicts;
+    uint64_t flushesAvoided;         // Taken branches redirected at fetch
+
+    uint32_t indexFor(uint32_t pc) const { return (pc >> 2) & indexMask; }
+
+public:
+    explicit BranchPredictor(Mode predictorMode = Mode::ALWAYS_STALL, size_t entries = 256)
+        : mode(predictorMode), resolves(0), correct(0), mispredicts(0), flushesAvoided(0)
+    {
+        // Round the table size up to a power of two for mask indexing
+        size_t size = 1;
+        while (size < entries) size <<= 1;
+        indexMask = (uint32_t)size - 1;
+        counters.assign(size, 1);    // Start weakly not-taken
+        btb.assign(size, BtbEntry());
+    }
+
+    bool enabled() const { return mode != Mode::ALWAYS_STALL; }
+
+    // Consult at fetch: returns true (and sets target) when the fetch
+    // should be redirected to the predicted target this cycle
+    bool predict(uint32_t pc, uint32_t& target) const {
+        if (mode == Mode::ALWAYS_STALL) return false;
+        uint32_t index = indexFor(pc);
+        const BtbEntry& entry = btb[index];
+        if (!entry.valid || entry.pc != pc) return false;
+        if (counters[index] < 2) return false;
+        target = entry.target;
+        return true;
+    }
+
+    // Resolve in EX: update the counter table and BTB, and return
+    // whether the front end must be flushed (the prediction was wrong)
+    bool resolve(uint32_t pc, bool taken, uint32_t target,
+                 bool predictedTaken, uint32_t predictedTarget) {
+        resolves++;
+        bool wasCorrect = (taken == predictedTaken) && (!taken || predictedTarget == target);
+        if (wasCorrect) {
+            correct++;
+            if (taken) flushesAvoided++;   // The redirect already happened at fetch
+        } else {
+            mispredicts++;
+        }
+
+        uint32_t index = indexFor(pc);
+        if (taken) {
+            if (counters[index] < 3) counters[index]++;
+            btb[index].pc = pc;
+            btb[index].target = target;
+            btb[index].valid = true;
+        } else {
+            if (counters[index] > 0) counters[index]--;
+        }
+        return !wasCorrect;
+    }
+
+    void printStats(std::ostream& out) const {
+        out << "Branch Predictor: resolved " << resolves
+            << ", correct " << correct
+            << ", mispredicted " << mispredicts;
+        if (resolves > 0) {
+            out << ", accuracy " << (100.0 * correct / resolves) << "%";
+        }
+        // Every avoided flush saves the two squashed fetch/decode slots
+        out << ", cycles saved " << (2 * flushesAvoided) << "\n";
+    }
+};
+
+#endif // BRANCHPREDICTOR_HPP
@@ -0,0 +1,68 @@
+#include "CacheMemory.hpp"
+#include "../../CACHE/Cache.h"
+#include "../../CACHE/Bus.h"
+
+// The CACHE bus fast-forwards its busy window against this global cycle
+// counter; the trace drivers define it in their own main.cpp, the
+// pipeline defines it here and advances it per memory access
+unsigned int currentGlobalCycle = 0;
+
+// Owns the single-core cache hierarchy; kept out of the header so the
+// C++11 pipeline sources never see the C++17 CACHE headers
+class CacheMemoryImpl {
+public:
+    Bus bus;
+    Cache cache;
+
+    CacheMemoryImpl(int setIndexBits, int associativity, int blockOffsetBits)
+        : bus(), cache(0, setIndexBits, associativity, blockOffsetBits, &bus) {
+        bus.registerCache(&cache, 0);
+        bus.connectCaches();
+    }
+};
+
+CacheMemory::CacheMemory(int setIndexBits, int associativity, int blockOffsetBits)
+    : impl(new CacheMemoryImpl(setIndexBits, associativity, blockOffsetBits)),
+      memoryStallCycles(0) {}
+
+CacheMemory::~CacheMemory() {
+    delete impl;
+}
+
+uint32_t CacheMemory::access(uint32_t address, bool isWrite) {
+    int cycles = 0;
+    bool accepted = isWrite ? impl->cache.write(address, cycles)
+                            : impl->cache.read(address, cycles);
+    if (!accepted) {
+        // The cache only refuses while blocked on an earlier miss; the
+        // pipeline models that stall itself, so unblock and retry once
+        impl->cache.unblock();
+        cycles = 0;
+        accepted = isWrite ? impl->cache.write(address, cycles)
+                           : impl->cache.read(address, cycles);
+    }
+    if (impl->cache.isBlocking()) {
+        impl->cache.unblock();
+    }
+    if (cycles < 1) {
+        cycles = 1;
+    }
+    memoryStallCycles += (uint32_t)cycles - 1;
+    // Keep the shared clock moving so the bus busy window expires
+    currentGlobalCycle += (unsigned int)cycles;
+    return (uint32_t)cycles;
+}
+
+void CacheMemory::printStats(std::ostream& out) const {
+    const Statistics& stats = impl->cache.getStatistics();
+    out << "Cache Statistics:\n";
+    out << "Cache Accesses: " << stats.getAccesses() << "\n";
+    out << "Cache Misses: " << stats.getMisses() << "\n";
+    if (stats.getAccesses() > 0) {
+        out << "Miss Rate: "
+            << (100.0 * stats.getMisses() / stats.getAccesses()) << "%\n";
+    }
+    out << "Evictions: " << stats.getEvictions() << "\n";
+    out << "Writebacks: " << stats.getWritebacks() << "\n";
+    out << "Memory Stall Cycles: " << memoryStallCycles << "\n";
+}
@@ -0,0 +1,39 @@
+#ifndef CACHEMEMORY_HPP
+#define CACHEMEMORY_HPP
+
+#include <cstdint>
+#include <ostream>
+
+// Timing adapter that lets the MEM stage drive a single-core Cache+Bus
+// pair from the CACHE project instead of the flat ideal memory array.
+// The cache model provides latency only (hit = 1 cycle, miss = bus +
+// memory latency); the data itself still lives in the pipeline's flat
+// memory array. The CACHE headers require C++17, so they stay behind
+// this opaque handle and only CacheMemory.cpp sees them.
+class CacheMemoryImpl;
+
+class CacheMemory {
+private:
+    CacheMemoryImpl* impl;
+    uint64_t memoryStallCycles;   // Extra cycles the pipeline froze for misses
+
+public:
+    // Geometry mirrors the CACHE CLI: set index bits (s), associativity
+    // (E), block offset bits (b)
+    explicit CacheMemory(int setIndexBits = 6, int associativity = 2, int blockOffsetBits = 5);
+    ~CacheMemory();
+    CacheMemory(const CacheMemory&) = delete;
+    CacheMemory& operator=(const CacheMemory&) = delete;
+
+    // Latency of one access in cycles (1 on a hit); the pipeline stalls
+    // for latency-1 extra cycles after the access
+    uint32_t access(uint32_t address, bool isWrite);
+
+    uint64_t stallCycles() const { return memoryStallCycles; }
+
+    // Combined report: cache hit/miss counters plus the stall cycles
+    // they cost the pipeline
+    void printStats(std::ostream& out) const;
+};
+
+#endif // CACHEMEMORY_HPP
@@ -0,0 +1,142 @@
+#ifndef DIAGRAMRECORDER_HPP
+#define DIAGRAMRECORDER_HPP
+
+#include <cstdint>
+#include <deque>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Pipeline stage identifiers for the diagram recorder
+enum class Stage : uint8_t {
+    NONE,  // Not in any stage (stall bubble between two runs)
+    IF, ID, EX, MEM, WB
+};
+
+// Streaming replacement for the old cycles-by-stages string matrix.
+// Each dynamic instruction gets one row holding run-length-encoded
+// stage occupancy ("IFx1,IDx1,stallx3,EXx1,..."), so memory per row is
+// proportional to the number of stage changes, not to the cycle count.
+// A row is streamed to the output as soon as the instruction retires
+// (or is known to be squashed because a younger instruction retired),
+// so only the handful of in-flight rows are ever held in memory and
+// million-instruction programs run in constant space.
+class DiagramRecorder {
+private:
+    // One run of consecutive cycles spent in the same stage
+    struct Run {
+        Stage stage;
+        uint32_t count;
+    };
+
+    // One dynamic instruction, in fetch order
+    struct Row {
+        std::string label;       // Assembly text of the instruction
+        uint32_t index;          // Static instruction index
+        uint32_t firstCycle;     // Cycle of the first recorded event
+        uint32_t nextCycle;      // Cycle after the last recorded event
+        bool done;               // Retired or squashed; safe to stream
+        std::vector<Run> runs;   // Run-length-encoded stage occupancy
+    };
+
+    std::ostream& out;
+    std::deque<Row> openRows;    // In-flight rows, oldest first
+
+    // Pipeline order of a stage, used to tell whether an event can
+    // belong to an already-open row
+    static int rank(Stage stage) {
+        return static_cast<int>(stage);
+    }
+
+    static const char* stageName(Stage stage) {
+        switch (stage) {
+            case Stage::IF:  return "IF";
+            case Stage::ID:  return "ID";
+            case Stage::EX:  return "EX";
+            case Stage::MEM: return "MEM";
+            case Stage::WB:  return "WB";
+            default:         return "stall";
+        }
+    }
+
+    // Write one completed row: "<asm>;<first cycle>;IFx1,IDx2,..."
+    void writeRow(const Row& row) {
+        out << row.label << ";" << row.firstCycle << ";";
+        for (size_t i = 0; i < row.runs.size(); ++i) {
+            if (i != 0) out << ",";
+            out << stageName(row.runs[i].stage) << "x" << row.runs[i].count;
+        }
+        out << "\n";
+    }
+
+    // Stream every completed row at the front of the queue
+    void flush() {
+        while (!openRows.empty() && openRows.front().done) {
+            writeRow(openRows.front());
+            openRows.pop_front();
+        }
+    }
+
+public:
+    explicit DiagramRecorder(std::ostream& outputStream) : out(outputStream) {}
+
+    // Record that instruction `index` occupied `stage` during `cycle`.
+    // The label (not required to be NUL-terminated) is only copied when
+    // the event starts a new row.
+    void record(uint32_t cycle, uint32_t index, Stage stage,
+                const char* label, size_t labelLength) {
+        // Attach the event to the oldest open row it can belong to: the
+        // same instruction either repeating its current stage on the
+        // next cycle (a stall) or moving to a later stage
+        for (size_t i = 0; i < openRows.size(); ++i) {
+            Row& row = openRows[i];
+            if (row.done || row.index != index) continue;
+            Stage last = row.runs.back().stage;
+            if (last == stage && row.nextCycle == cycle) {
+                row.runs.back().count++;
+                row.nextCycle = cycle + 1;
+                return;
+            }
+            if (rank(last) < rank(stage)) {
+                // Cycles with no event for this row are stall bubbles
+                if (cycle > row.nextCycle) {
+                    openRows[i].runs.push_back({Stage::NONE, cycle - row.nextCycle});
+                }
+                row.runs.push_back({stage, 1});
+                row.nextCycle = cycle + 1;
+                if (stage == Stage::WB) {
+                    // Retirement is in order, so every older row still
+                    // open was squashed and can be streamed too
+                    for (size_t j = 0; j <= i; ++j) {
+                        openRows[j].done = true;
+                    }
+                    flush();
+                }
+                return;
+            }
+        }
+
+        // No open row matches: this event starts a new dynamic instruction
+        Row row;
+        row.label.assign(label, labelLength);
+        row.index = index;
+        row.firstCycle = cycle;
+        row.nextCycle = cycle + 1;
+        row.done = (stage == Stage::WB);
+        row.runs.push_back({stage, 1});
+        openRows.push_back(row);
+        if (row.done) {
+            flush();
+        }
+    }
+
+    // Stream everything still in flight; call once after the last cycle
+    void finish() {
+        for (size_t i = 0; i < openRows.size(); ++i) {
+            openRows[i].done = true;
+        }
+        flush();
+    }
+};
+
+#endif // DIAGRAMRECORDER_HPP
@@ -0,0 +1,45 @@
+#ifndef MICROOP_HPP
+#define MICROOP_HPP
+
+#include <cstdint>
+
+// Decoded ALU / branch / memory operation. One byte instead of a
+// heap-allocated string, so pipeline registers can be copied and
+// compared without touching the allocator every cycle.
+enum class AluOp : uint8_t {
+    NONE,
+    // R-type arithmetic and logic
+    ADD, SUB, AND, OR, XOR, SLL, SRL, SRA, SLT, SLTU,
+    // I-type immediates
+    ADDI, SLTI, SLTIU, XORI, ORI, ANDI, SLLI, SRLI, SRAI,
+    // Branches
+    BEQ, BNE, BLT, BGE, BLTU, BGEU,
+    // Memory and jumps
+    LB, SB, JAL, JALR
+};
+
+// Broad instruction class, previously carried as a string ("R", "I", ...)
+enum class InstrType : uint8_t {
+    OTHER, R, I, B, LOAD, STORE, JUMP
+};
+
+// Decoded micro-op produced by the ID stage and routed through the
+// pipeline registers. The control signals are packed into single-bit
+// fields so the whole struct copies as a couple of bytes.
+struct MicroOp {
+    AluOp op;
+    InstrType type;
+    uint8_t writeEnable : 1;   // Instruction writes the register file
+    uint8_t isIType : 1;       // Second operand comes from the immediate
+    uint8_t isLoad : 1;        // Instruction reads data memory
+    uint8_t usesRs2 : 1;       // Second source register is meaningful
+    uint8_t readMemory : 1;    // MEM stage performs a load
+    uint8_t writeMemory : 1;   // MEM stage performs a store
+
+    MicroOp()
+        : op(AluOp::NONE), type(InstrType::OTHER),
+          writeEnable(0), isIType(0), isLoad(0),
+          usesRs2(0), readMemory(0), writeMemory(0) {}
+};
+
+#endif // MICROOP_HPP
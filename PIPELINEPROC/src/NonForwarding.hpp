@@ -1,116 +1,57 @@
 #ifndef NOFORWARD_PROCESSOR_HPP
 #define NOFORWARD_PROCESSOR_HPP
 
-#include <iostream>
-#include <cstdint>
-#include <array>
-#include <vector>
-#include <string>
-#include <fstream>
-
-// Base class structures
-struct PipelinePhases {
-    std::string Fetch;
-    std::string Decode;
-    std::string Execute;
-    std::string Memory;
-    std::string WriteBack;
-};
-
-struct InstructionPhases {
-    std::string command;
-    std::vector<std::string> phases;
-};
-
-// Register bank class
-class RegisterBank {
-    private:
-        std::array<uint32_t, 32> regArray;
-    public:
-        RegisterBank() { regArray.fill(0); }
-        uint32_t fetch(uint8_t regNum) const { return regArray[regNum]; }
-        void store(uint8_t regNum, uint32_t value) {
-            if (regNum != 0) regArray[regNum] = value;
-        }
-};
-
-// Base processor class
-class ProcessorCore {
-    protected:
-        std::ifstream sourceFile;
-        uint32_t instructionPtr = 0;
-        RegisterBank regBank;
-        std::vector<PipelinePhases> executionFlow;
-        std::vector<InstructionPhases> commandList;
-        PipelinePhases currentPhase;
-
-        // Pipeline registers
-        struct FetchDecode_Reg {
-            uint32_t instruction, counter;
-            bool bubble;
-        } fetchDecode;
-        
-        struct DecodeExec_Reg {
-            uint32_t operation, src1, src2, dest;
-            int32_t immediate;
-            uint32_t control3;
-            uint32_t control7;
-            std::string execOperation;
-            bool bubble;
-            bool writeEnabled;
-            bool immediateType;
-            bool usesSource2 = false;
-            uint32_t counter;
-        } decodeExec;
-        
-        struct ExecMem_Reg {
-            uint32_t dest;
-            uint32_t execResult;
-            bool memRead;
-            bool memWrite;
-            bool writeEnabled;
-            bool bubble;
-            uint32_t counter;
-        } execMem={0,0,false,false,false,false};
-        
-        struct MemWrite_Reg {
-            uint32_t writeData;
-            uint32_t dest;
-            bool writeEnabled;
-            bool bubble;
-            uint32_t counter;
-        } memWrite={0,0,false,false};
-
-    public:
-        ProcessorCore(const std::string& filename) {
-            sourceFile.open(filename);
-            if (!sourceFile) {
-                std::cerr << "Error opening file: " << filename << std::endl;
-                exit(1);
-            }
-        }
-        virtual ~ProcessorCore() = default;
-        virtual void simulate(uint32_t cycles) = 0;
+#include "Processor.hpp"
+
+// Policy for the stall-only processor: no bypass paths, so the decode
+// stage stalls against every in-flight producer (EX, MEM, and WB) until
+// the value has been written back. EX covers the full arithmetic set
+// and resolves conditional branches.
+struct StallPolicy {
+    static const bool hasForwarding = false;
+    static const bool fullAluCoverage = true;
+    static const bool executesBranches = true;
+
+    // Decode table (implemented in NonForwarding.cpp)
+    static void decode(uint32_t instruction, ID_EX_Reg& decodedInstr);
+
+    // Stall against the nearest in-flight producer: EX (0) and MEM (1)
+    // hold the instruction in decode, WB (2) releases it this cycle
+    static int detectHazard(const ID_EX_Reg& decoded, const ID_EX_Reg& idEx,
+                            const EX_MEM_Reg& exMem, const MEM_WB_Reg& memWb,
+                            int& /*stallFlag*/) {
+        bool executeHazard = (idEx.uop.writeEnable && idEx.destReg != 0 &&
+                              (idEx.destReg == decoded.sourceReg1 ||
+                               (decoded.uop.usesRs2 && idEx.destReg == decoded.sourceReg2)));
+
+        bool memoryHazard = (exMem.uop.writeEnable && exMem.destReg != 0 &&
+                             (exMem.destReg == decoded.sourceReg1 ||
+                              (decoded.uop.usesRs2 && exMem.destReg == decoded.sourceReg2)));
+
+        bool writebackHazard = (memWb.uop.writeEnable && memWb.destReg != 0 &&
+                                (memWb.destReg == decoded.sourceReg1 ||
+                                 (decoded.uop.usesRs2 && memWb.destReg == decoded.sourceReg2)));
+
+        if (executeHazard) return 0;
+        if (memoryHazard) return 1;
+        if (writebackHazard) return 2;
+        return -1;
+    }
+
+    // Branches are the only instructions decoded without a destination
+    static bool writeEnableAfterDecode(AluOp op) { return op != AluOp::BEQ; }
+
+    // JALR target is rs1 + offset with the least significant bit cleared
+    static uint32_t jalrTarget(uint32_t /*rs1Index*/, uint32_t rs1Value, int32_t immediate) {
+        return (rs1Value + static_cast<uint32_t>(immediate)) & ~(uint32_t)1;
+    }
 };
 
-// Command structure for derived class
-struct Command {
-    std::string assemblyCode;
-    uint32_t binaryCode;
-};
-
-// Derived processor class
-class BasicProcessor : public ProcessorCore {
-    private:
-        void parseInstruction(uint32_t code, DecodeExec_Reg& decodedInstr);
-        int32_t extractImmediate(const std::string& assembly);
-
-    public:
-        explicit BasicProcessor(const std::string& filename);
-        std::vector<Command> programCommands;
-        std::vector<std::vector<std::string>> executionTrace;
-        void simulate(uint32_t cycles) override;
-        uint8_t readMemory(uint32_t location);
+// Stall-only processor (historical name, kept for compatibility with
+// existing drivers)
+class BasicProcessor : public Processor<StallPolicy> {
+public:
+    using Processor<StallPolicy>::Processor;
 };
 
-#endif // NOFORWARD_PROCESSOR_HPP
\ No newline at end of file
+#endif // NOFORWARD_PROCESSOR_HPP
@@ -0,0 +1,54 @@
+#ifndef PIPELINESTATS_HPP
+#define PIPELINESTATS_HPP
+
+#include <cstdint>
+#include <ostream>
+#include "MicroOp.hpp"
+
+// Counters for the headless (stats-only) simulation mode. When the
+// processors run without the diagram recorder this is all they keep:
+// a few integers, updated with plain increments in the cycle loop.
+struct PipelineStats {
+    static const int CLASS_COUNT = 7;  // One slot per InstrType value
+
+    uint64_t totalCycles;              // Cycles simulated
+    uint64_t stallCycles;              // Cycles lost to hazard stalls
+    uint64_t retired;                  // Instructions that reached WB
+    uint64_t classRetired[CLASS_COUNT];
+    uint64_t classCycles[CLASS_COUNT]; // Summed fetch-to-retire latency
+
+    PipelineStats() : totalCycles(0), stallCycles(0), retired(0) {
+        for (int i = 0; i < CLASS_COUNT; ++i) {
+            classRetired[i] = 0;
+            classCycles[i] = 0;
+        }
+    }
+
+    // Called once per retiring instruction with its fetch-to-WB latency
+    void recordRetire(InstrType type, uint32_t cyclesInFlight) {
+        retired++;
+        classRetired[static_cast<int>(type)]++;
+        classCycles[static_cast<int>(type)] += cyclesInFlight;
+    }
+
+    void print(std::ostream& out) const {
+        static const char* names[CLASS_COUNT] =
+            {"OTHER", "R", "I", "B", "LOAD", "STORE", "JUMP"};
+        out << "Simulation Statistics:\n";
+        out << "Total Cycles: " << totalCycles << "\n";
+        out << "Instructions Retired: " << retired << "\n";
+        out << "Stall Cycles: " << stallCycles << "\n";
+        if (retired > 0) {
+            out << "Overall CPI: " << (double)totalCycles / retired << "\n";
+        }
+        // Per-class CPI is the average fetch-to-retire latency of the
+        // instructions in that class
+        for (int i = 0; i < CLASS_COUNT; ++i) {
+            if (classRetired[i] == 0) continue;
+            out << "Class " << names[i] << ": retired " << classRetired[i]
+                << ", CPI " << (double)classCycles[i] / classRetired[i] << "\n";
+        }
+    }
+};
+
+#endif // PIPELINESTATS_HPP
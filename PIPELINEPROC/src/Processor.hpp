@@ -0,0 +1,783 @@
+#ifndef PROCESSOR_HPP
+#define PROCESSOR_HPP
+
+#include <iostream>
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "MicroOp.hpp"
+#include "ALU.hpp"
+#include "BranchPredictor.hpp"
+#include "DiagramRecorder.hpp"
+#include "PipelineStats.hpp"
+#include "CacheMemory.hpp"
+
+// Single five-stage simulation engine shared by both processors. The
+// forwarding/stall differences are supplied by a policy type resolved
+// at compile time (see ForwardingPolicy in Forwarding.hpp and
+// StallPolicy in NonForwarding.hpp), so each instantiation's cycle loop
+// contains only the hazard checks and ALU paths it actually needs, and
+// a fix in the shared loop applies to both processors at once.
+
+// Pipeline Register Structures
+struct IF_ID_Reg {
+    uint32_t instruction;
+    uint32_t pc;
+    uint32_t fetchCycle;   // Cycle the instruction was fetched (for CPI stats)
+    bool isNop;
+    bool predictedTaken;        // Fetch was redirected by the branch predictor
+    uint32_t predictedTarget;   // Where the predictor sent the fetch
+};
+
+struct ID_EX_Reg {
+    uint32_t opcode;
+    uint32_t sourceReg1;
+    uint32_t sourceReg2;
+    uint32_t destReg;
+    int32_t immediate;
+    uint32_t funct3;
+    uint32_t funct7;
+    MicroOp uop;       // Decoded operation, type, and control signals
+    bool isNop;
+    uint32_t pc;
+    uint32_t fetchCycle;
+    bool predictedTaken;        // Carried from IF_ID for resolution in EX
+    uint32_t predictedTarget;
+};
+
+struct EX_MEM_Reg {
+    uint32_t destReg;
+    uint32_t aluResult;
+    MicroOp uop;       // Carried forward from ID_EX
+    bool isNop;
+    uint32_t pc;
+    uint32_t fetchCycle;
+    uint32_t storeData;
+};
+
+struct MEM_WB_Reg {
+    uint32_t writebackData;
+    uint32_t destReg;
+    MicroOp uop;       // Carried forward from EX_MEM
+    bool isNop;
+    uint32_t pc;
+    uint32_t fetchCycle;
+};
+
+// One loaded instruction: machine code plus the location of its
+// assembly text in the processor's shared string arena
+struct InstructionEntry {
+    uint32_t machineCode;
+    uint32_t assemblyOffset;   // Offset into the assembly arena
+    uint32_t assemblyLength;
+};
+
+// Register File class
+class RegisterFile {
+private:
+    std::array<uint32_t, 32> registers;  // RISC-V 32 registers
+
+public:
+    RegisterFile() { registers.fill(0); }
+
+    uint32_t read(uint8_t regIndex) const {
+        return registers[regIndex];
+    }
+
+    void write(uint8_t regIndex, uint32_t value) {
+        if (regIndex != 0) registers[regIndex] = value;  // x0 is hardwired to 0
+    }
+};
+
+// Base Processor class
+class ProcessorBase {
+protected:
+    std::ifstream instructionFile;        // Input file stream
+    RegisterFile registerFile;            // Register File
+
+    // Pipeline registers
+    IF_ID_Reg IF_ID = {};
+    ID_EX_Reg ID_EX = {};
+    EX_MEM_Reg EX_MEM = {};
+    MEM_WB_Reg MEM_WB = {};
+
+public:
+    // Constructor
+    ProcessorBase(const std::string& filename) {
+        instructionFile.open(filename);
+        if (!instructionFile) {
+            std::cerr << "Failed to open file: " << filename << std::endl;
+            exit(1);
+        }
+    }
+
+    // Virtual simulation function
+    virtual void simulate(uint32_t numCycles) = 0;
+
+    // Virtual destructor
+    virtual ~ProcessorBase() {
+        if (instructionFile.is_open()) {
+            instructionFile.close();
+        }
+    }
+};
+
+// The shared engine. The policy supplies, at compile time:
+//   hasForwarding      - EX/MEM and MEM/WB results bypass into EX
+//   fullAluCoverage    - EX executes the full arithmetic/compare set
+//                        (otherwise only ADD/ADDI/LB, as the original
+//                        forwarding processor did)
+//   executesBranches   - EX resolves conditional branches
+//   decode()           - the instruction decode table
+//   detectHazard()     - stall decisions against the pipeline registers
+//   writeEnableAfterDecode() - the post-decode write-enable override
+//   jalrTarget()       - the JALR target calculation
+template <typename Policy>
+class Processor : public ProcessorBase {
+private:
+    // Every instruction decoded once at load time, indexed by pc/4, so
+    // the ID stage is an array lookup instead of a per-cycle decode
+    std::vector<ID_EX_Reg> predecoded;
+
+    // Pre-parsed JAL/JALR immediates (0 for everything else), so the EX
+    // stage never re-tokenizes the assembly text
+    std::vector<int32_t> jumpImmediates;
+
+    // Headless mode: skip all diagram bookkeeping and print cycle,
+    // stall, and per-class CPI counters instead
+    bool statsOnly;
+
+    // Branch predictor consulted at fetch and trained in EX; the
+    // ALWAYS_STALL baseline leaves behavior exactly as before
+    BranchPredictor predictor;
+
+    // Counters from the most recent simulate() call, kept so harnesses
+    // can read results without parsing the printed output
+    PipelineStats lastRunStats;
+
+    // Optional cache model for the MEM stage; null means the flat ideal
+    // memory (every access one cycle) as before
+    CacheMemory* dataCache = nullptr;
+
+    // Flat data memory backing loadByte, one array per instantiation
+    static uint8_t mainMemory[102400];
+
+    // All assembly text interned back to back in one allocation;
+    // InstructionEntry holds offsets into it
+    std::vector<char> assemblyArena;
+
+    static int32_t parseImmediateValue(const std::string& assemblyString);
+
+    // Parse the whole program image in place (no per-line temporaries)
+    void loadProgram(const char* data, size_t size);
+
+    const char* assemblyText(uint32_t index) const {
+        return assemblyArena.data() + instructionMemory[index].assemblyOffset;
+    }
+    uint32_t assemblyLength(uint32_t index) const {
+        return instructionMemory[index].assemblyLength;
+    }
+
+public:
+    std::vector<InstructionEntry> instructionMemory;   // loaded from file
+
+    explicit Processor(const std::string& filename, bool statsOnlyMode = false,
+                       bool predictorEnabled = false, size_t predictorEntries = 256);
+
+    ~Processor() override { delete dataCache; }
+
+    // Route MEM-stage accesses through a Cache instance from the CACHE
+    // project; misses freeze the pipeline for the miss latency
+    void attachCache(int setIndexBits = 6, int associativity = 2, int blockOffsetBits = 5);
+
+    // Simulate the processor for a given number of cycles
+    void simulate(uint32_t cycleCount) override;
+
+    // Simulate memory byte access
+    uint8_t loadByte(uint32_t memoryAddress);
+
+    // Counters from the most recent simulate() call
+    const PipelineStats& lastStats() const { return lastRunStats; }
+};
+
+template <typename Policy>
+uint8_t Processor<Policy>::mainMemory[102400] = {};
+
+// Implement the loadByte function to simulate memory access
+template <typename Policy>
+uint8_t Processor<Policy>::loadByte(uint32_t memoryAddress) {
+    // Check if the address is within bounds (i.e., within the size of the memory array)
+    if (memoryAddress >= sizeof(mainMemory)) {
+        std::cerr << "Memory access violation at address " << memoryAddress << std::endl;
+        return 0;  // Return a dummy value (0) if the address is out of bounds
+    } else {
+        return mainMemory[memoryAddress];  // Return the byte at the given address
+    }
+}
+
+template <typename Policy>
+Processor<Policy>::Processor(const std::string& filename, bool statsOnlyMode,
+                             bool predictorEnabled, size_t predictorEntries)
+    : ProcessorBase(filename), statsOnly(statsOnlyMode),
+      predictor(predictorEnabled ? BranchPredictor::Mode::TWO_BIT
+                                 : BranchPredictor::Mode::ALWAYS_STALL,
+                predictorEntries) {
+    // Map the file once and parse it in place; fall back to reading it
+    // through the already-open stream when mapping is not possible
+    // (e.g. the input is a pipe)
+    bool loaded = false;
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat fileInfo;
+        if (fstat(fd, &fileInfo) == 0 && S_ISREG(fileInfo.st_mode)) {
+            if (fileInfo.st_size == 0) {
+                loaded = true;   // Empty program
+            } else {
+                void* mapped = mmap(nullptr, (size_t)fileInfo.st_size,
+                                    PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapped != MAP_FAILED) {
+                    loadProgram((const char*)mapped, (size_t)fileInfo.st_size);
+                    munmap(mapped, (size_t)fileInfo.st_size);
+                    loaded = true;
+                }
+            }
+        }
+        ::close(fd);
+    }
+    if (!loaded) {
+        std::stringstream buffer;
+        buffer << instructionFile.rdbuf();
+        std::string contents = buffer.str();
+        loadProgram(contents.data(), contents.size());
+    }
+
+    // Predecode the whole program once; the ID stage then just indexes
+    // this table instead of re-decoding on every cycle
+    predecoded.resize(instructionMemory.size());
+    jumpImmediates.resize(instructionMemory.size());
+    for (size_t i = 0; i < instructionMemory.size(); ++i) {
+        Policy::decode(instructionMemory[i].machineCode, predecoded[i]);
+        if (predecoded[i].uop.op == AluOp::JAL || predecoded[i].uop.op == AluOp::JALR) {
+            jumpImmediates[i] = parseImmediateValue(
+                std::string(assemblyText(i), assemblyLength(i)));
+        }
+    }
+}
+
+template <typename Policy>
+void Processor<Policy>::loadProgram(const char* data, size_t size) {
+    size_t lineStart = 0;
+    while (lineStart < size) {
+        size_t lineEnd = lineStart;
+        while (lineEnd < size && data[lineEnd] != '\n') lineEnd++;
+        if (lineEnd == lineStart) {   // Empty line
+            lineStart = lineEnd + 1;
+            continue;
+        }
+
+        // Walk the tokens of [lineStart, lineEnd) in place
+        size_t cursor = lineStart;
+        auto skipSpaces = [&]() {
+            while (cursor < lineEnd &&
+                   (data[cursor] == ' ' || data[cursor] == '\t' || data[cursor] == '\r')) {
+                cursor++;
+            }
+        };
+        auto skipToken = [&]() {
+            while (cursor < lineEnd &&
+                   data[cursor] != ' ' && data[cursor] != '\t' && data[cursor] != '\r') {
+                cursor++;
+            }
+        };
+
+        // Token 1: address (ignored, as before)
+        skipSpaces();
+        size_t addressStart = cursor;
+        skipToken();
+
+        // Token 2: machine code in hex
+        skipSpaces();
+        size_t codeStart = cursor;
+        skipToken();
+        size_t codeEnd = cursor;
+
+        if (addressStart == lineEnd || codeStart == codeEnd) {
+            std::cerr << "Invalid instruction format: "
+                      << std::string(data + lineStart, lineEnd - lineStart) << std::endl;
+            exit(1);
+        }
+
+        // Parse the leading hex digits (optional 0x prefix), matching
+        // what std::stoul accepted
+        size_t digitPos = codeStart;
+        if (codeEnd - digitPos > 2 && data[digitPos] == '0' &&
+            (data[digitPos + 1] == 'x' || data[digitPos + 1] == 'X')) {
+            digitPos += 2;
+        }
+        uint32_t machineCode = 0;
+        bool haveDigits = false;
+        for (; digitPos < codeEnd; ++digitPos) {
+            char c = data[digitPos];
+            int value;
+            if (c >= '0' && c <= '9') value = c - '0';
+            else if (c >= 'a' && c <= 'f') value = c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') value = c - 'A' + 10;
+            else break;
+            machineCode = (machineCode << 4) | (uint32_t)value;
+            haveDigits = true;
+        }
+        if (!haveDigits) {
+            std::cerr << "Failed to parse instruction: "
+                      << std::string(data + lineStart, lineEnd - lineStart) << "\n";
+            exit(1);
+        }
+
+        // Tokens 3+: assembly text, interned into the arena with single
+        // spaces between tokens (as the old tokenizer produced)
+        uint32_t assemblyOffset = (uint32_t)assemblyArena.size();
+        size_t assemblyTokens = 0;
+        for (;;) {
+            skipSpaces();
+            if (cursor >= lineEnd) break;
+            size_t tokenStart = cursor;
+            skipToken();
+            if (assemblyTokens != 0) assemblyArena.push_back(' ');
+            assemblyArena.insert(assemblyArena.end(),
+                                 data + tokenStart, data + cursor);
+            assemblyTokens++;
+        }
+        if (assemblyTokens == 0) {
+            std::cerr << "Invalid instruction format: "
+                      << std::string(data + lineStart, lineEnd - lineStart) << std::endl;
+            exit(1);
+        }
+
+        InstructionEntry entry;
+        entry.machineCode = machineCode;
+        entry.assemblyOffset = assemblyOffset;
+        entry.assemblyLength = (uint32_t)assemblyArena.size() - assemblyOffset;
+        instructionMemory.push_back(entry);
+
+        lineStart = lineEnd + 1;
+    }
+}
+
+template <typename Policy>
+void Processor<Policy>::attachCache(int setIndexBits, int associativity, int blockOffsetBits) {
+    delete dataCache;
+    dataCache = new CacheMemory(setIndexBits, associativity, blockOffsetBits);
+}
+
+template <typename Policy>
+int32_t Processor<Policy>::parseImmediateValue(const std::string& assemblyString) {
+    std::string processedString = assemblyString;
+    // Replace commas, parentheses, and brackets with spaces to handle different formats
+    for (char& c : processedString) {
+        if (c == ',' || c == '(' || c == ')') {
+            c = ' ';
+        }
+    }
+    std::vector<std::string> tokens;
+    std::istringstream tokenStream(processedString);
+    std::string currentToken;
+    while (tokenStream >> currentToken) {
+        tokens.push_back(currentToken);
+    }
+    // Iterate tokens in reverse to find the last numeric token (immediate)
+    for (auto it = tokens.rbegin(); it != tokens.rend(); ++it) {
+        std::string token = *it;
+        try {
+            size_t position;
+            int32_t immediateValue = std::stol(token, &position, 0); // Allow decimal and hex (0x) formats
+            if (position == token.size()) {
+                return immediateValue;
+            }
+        } catch (const std::exception& e) {
+            // Not a valid number, continue to next token
+            continue;
+        }
+    }
+    std::cerr << "Error: Could not parse immediate from assembly string: " << assemblyString << std::endl;
+    return 0; // Return 0 as a fallback
+}
+
+template <typename Policy>
+void Processor<Policy>::simulate(uint32_t cycleCount) {
+    // Rows are streamed as instructions retire, so memory stays flat no
+    // matter how many cycles are simulated; in stats-only mode the
+    // recorder is bypassed entirely and only counters are kept
+    DiagramRecorder recorder(std::cout);
+    PipelineStats stats;
+    if (!statsOnly) {
+        std::cout << "Pipeline Diagram:\n";
+    }
+    uint32_t targetPC = 0;
+    uint32_t programCounter = 0;
+    int stallFlag = 0;
+
+    IF_ID.isNop = true;
+    ID_EX.isNop = true;
+    EX_MEM.isNop = true;
+    MEM_WB.isNop = true;
+    uint32_t currentCycle = 0;
+    uint32_t memoryStallRemaining = 0;
+    while (currentCycle < cycleCount) {
+        // A cache miss freezes the whole pipeline: no register moves
+        // until the miss latency has elapsed
+        if (memoryStallRemaining > 0) {
+            memoryStallRemaining--;
+            stats.stallCycles++;
+            currentCycle++;
+            continue;
+        }
+        bool isBranchTaken = false;
+        bool skipFetch = false;
+        int hazardIndicator = -1;
+        bool hasDataHazard = false;
+
+        //----------WB stage-------------------
+        if (!MEM_WB.isNop && MEM_WB.uop.writeEnable) {
+            // Write the result back to the register file
+            registerFile.write(MEM_WB.destReg, MEM_WB.writebackData);
+            stats.recordRetire(MEM_WB.uop.type, currentCycle - MEM_WB.fetchCycle + 1);
+            uint32_t retireIndex = MEM_WB.pc / 4;
+            if (!statsOnly && retireIndex < instructionMemory.size()) {
+                recorder.record(currentCycle, retireIndex, Stage::WB,
+                                assemblyText(retireIndex), assemblyLength(retireIndex));
+            }
+        }
+
+        //-----------MEM stage---------------------
+        MEM_WB_Reg nextMemWb = {};
+        nextMemWb.isNop = EX_MEM.isNop;
+        if (!EX_MEM.isNop) {
+            if (EX_MEM.uop.readMemory) {
+                // With a cache attached, charge the access latency and
+                // freeze the pipeline for the remainder on a miss
+                if (dataCache != nullptr) {
+                    memoryStallRemaining = dataCache->access(EX_MEM.aluResult, false) - 1;
+                }
+                // For a load, read 4 bytes from memory using loadByte and combine them
+                uint32_t memoryData = 0;
+                memoryData |= loadByte(EX_MEM.aluResult);
+                memoryData |= loadByte(EX_MEM.aluResult + 1) << 8;
+                memoryData |= loadByte(EX_MEM.aluResult + 2) << 16;
+                memoryData |= loadByte(EX_MEM.aluResult + 3) << 24;
+                nextMemWb.writebackData = memoryData;
+            } else {
+                // For arithmetic instructions, simply forward the ALU result
+                nextMemWb.writebackData = EX_MEM.aluResult;
+            }
+            uint32_t memIndex = EX_MEM.pc / 4;
+            if (!statsOnly && memIndex < instructionMemory.size()) {
+                recorder.record(currentCycle, memIndex, Stage::MEM,
+                                assemblyText(memIndex), assemblyLength(memIndex));
+            }
+            nextMemWb.destReg = EX_MEM.destReg;
+            nextMemWb.pc = EX_MEM.pc;
+            nextMemWb.fetchCycle = EX_MEM.fetchCycle;
+            nextMemWb.uop = EX_MEM.uop;
+        }
+
+        //-----------------EX STAGE---------------------
+        EX_MEM_Reg nextExMem = {};
+        nextExMem.isNop = ID_EX.isNop;
+        if (!ID_EX.isNop) {
+            // Fetch operand values from the register file
+            uint32_t sourceOperand1 = registerFile.read(ID_EX.sourceReg1);
+            uint32_t sourceOperand2 = registerFile.read(ID_EX.sourceReg2);
+            if (Policy::hasForwarding) {
+                // Bypass EX/MEM and MEM/WB results into EX, newest first
+                if (!EX_MEM.isNop && EX_MEM.uop.writeEnable && EX_MEM.destReg != 0) {
+                    if (EX_MEM.destReg == ID_EX.sourceReg1) {
+                        sourceOperand1 = EX_MEM.aluResult;
+                    }
+                    if (ID_EX.uop.usesRs2 && EX_MEM.destReg == ID_EX.sourceReg2) {
+                        sourceOperand2 = EX_MEM.aluResult;
+                    }
+                }
+                if (!MEM_WB.isNop && MEM_WB.uop.writeEnable && MEM_WB.destReg != 0) {
+                    if (MEM_WB.destReg == ID_EX.sourceReg1 &&
+                        !(EX_MEM.uop.writeEnable && EX_MEM.destReg != 0 && EX_MEM.destReg == ID_EX.sourceReg1)) {
+                        sourceOperand1 = MEM_WB.writebackData;
+                    }
+                    if (ID_EX.uop.usesRs2 && MEM_WB.destReg == ID_EX.sourceReg2 &&
+                        !(EX_MEM.uop.writeEnable && EX_MEM.destReg != 0 && EX_MEM.destReg == ID_EX.sourceReg2)) {
+                        sourceOperand2 = MEM_WB.writebackData;
+                    }
+                }
+            }
+            if (ID_EX.uop.isIType) {
+                sourceOperand2 = static_cast<uint32_t>(ID_EX.immediate);
+            }
+
+            AluOp op = ID_EX.uop.op;
+            // Arithmetic, logical, and shift operations
+            if (op == AluOp::ADD || op == AluOp::ADDI || op == AluOp::LB ||
+                (Policy::fullAluCoverage &&
+                 (op == AluOp::SUB || op == AluOp::AND || op == AluOp::OR ||
+                  op == AluOp::XOR || op == AluOp::SLL || op == AluOp::SRL ||
+                  op == AluOp::SRA))) {
+                nextExMem.aluResult = ALU::execute(op, sourceOperand1, sourceOperand2);
+            }
+            // Branch operations
+            else if (Policy::executesBranches &&
+                     (op == AluOp::BEQ || op == AluOp::BNE ||
+                      op == AluOp::BLT || op == AluOp::BGE)) {
+                bool conditionMet = ALU::branchCondition(op, sourceOperand1, sourceOperand2);
+                // Calculate branch target using ALU
+                uint32_t branchTarget = ALU::execute(AluOp::ADD, ID_EX.pc, ID_EX.immediate);
+                // Resolve against the prediction made at fetch; flush only
+                // when the predictor (or the not-taken baseline) was wrong
+                if (predictor.resolve(ID_EX.pc, conditionMet, branchTarget,
+                                      ID_EX.predictedTaken, ID_EX.predictedTarget)) {
+                    isBranchTaken = true;
+                    targetPC = conditionMet ? branchTarget : ID_EX.pc + 4;
+                }
+                nextExMem.aluResult = 0;
+            }
+            // Jump operations
+            else if (op == AluOp::JAL) {
+                // Calculate target and return address
+                uint32_t currentPC = ID_EX.pc;
+                uint32_t computedTarget = 0;
+                uint32_t nextSequentialPC = currentPC + 4;
+                nextExMem.aluResult = nextSequentialPC;
+
+                uint32_t instructionIndex = currentPC / 4;
+                if (instructionIndex < instructionMemory.size()) {
+                    computedTarget = currentPC + jumpImmediates[instructionIndex];
+                } else {
+                    std::cerr << "Invalid PC for JAL/JALR instruction: " << currentPC << std::endl;
+                }
+
+                // Resolve against the prediction made at fetch; flush only
+                // when the predictor (or the not-taken baseline) was wrong
+                bool isTaken = (computedTarget != nextSequentialPC);
+                if (predictor.resolve(currentPC, isTaken, computedTarget,
+                                      ID_EX.predictedTaken, ID_EX.predictedTarget)) {
+                    isBranchTaken = true;
+                    targetPC = isTaken ? computedTarget : nextSequentialPC;
+                }
+            }
+            else if (op == AluOp::JALR) {
+                uint32_t currentPC = ID_EX.pc;
+                uint32_t computedTarget = 0;
+                uint32_t nextSequentialPC = currentPC + 4;
+                nextExMem.aluResult = nextSequentialPC;
+
+                uint32_t instructionIndex = currentPC / 4;
+                if (instructionIndex < instructionMemory.size()) {
+                    computedTarget = Policy::jalrTarget(ID_EX.sourceReg1, sourceOperand1,
+                                                        jumpImmediates[instructionIndex]);
+                } else {
+                    std::cerr << "Invalid PC for JAL/JALR instruction: " << currentPC << std::endl;
+                }
+
+                // Resolve against the prediction made at fetch; flush only
+                // when the predictor (or the not-taken baseline) was wrong
+                bool isTaken = (computedTarget != nextSequentialPC);
+                if (predictor.resolve(currentPC, isTaken, computedTarget,
+                                      ID_EX.predictedTaken, ID_EX.predictedTarget)) {
+                    isBranchTaken = true;
+                    targetPC = isTaken ? computedTarget : nextSequentialPC;
+                }
+            }
+            // Compare operations
+            else if (Policy::fullAluCoverage &&
+                     (op == AluOp::SLT || op == AluOp::SLTU)) {
+                nextExMem.aluResult = ALU::execute(op, sourceOperand1, sourceOperand2);
+            }
+            // Default case
+            else {
+                nextExMem.aluResult = 0;
+            }
+
+            uint32_t exIndex = ID_EX.pc / 4;
+            if (!statsOnly && exIndex < instructionMemory.size()) {
+                recorder.record(currentCycle, exIndex, Stage::EX,
+                                assemblyText(exIndex), assemblyLength(exIndex));
+            }
+            nextExMem.destReg = ID_EX.destReg;
+            nextExMem.fetchCycle = ID_EX.fetchCycle;
+            nextExMem.uop = ID_EX.uop;
+            // Set memory read flag for load instructions
+            nextExMem.uop.readMemory = (ID_EX.uop.op == AluOp::LB);
+            nextExMem.pc = ID_EX.pc;
+            // For simplicity, we are not implementing store instructions here
+            nextExMem.uop.writeMemory = 0;
+        }
+
+        // --------------------- ID Stage ---------------------
+        ID_EX_Reg nextIdEx = {};
+        nextIdEx.isNop = IF_ID.isNop;
+
+        if (!IF_ID.isNop) {
+            // Decoded once at load time; ID is now just an array index
+            const ID_EX_Reg& decodedInstruction = predecoded[IF_ID.pc / 4];
+
+            // Stall decision is the policy's: the forwarding processor
+            // only stalls on load-use, the stall-only processor against
+            // every in-flight producer
+            hazardIndicator = Policy::detectHazard(decodedInstruction, ID_EX,
+                                                   EX_MEM, MEM_WB, stallFlag);
+
+            if (hazardIndicator == 0 || hazardIndicator == 1) {
+                skipFetch = true;
+                stats.stallCycles++;
+                if (hazardIndicator == 0) {
+                    uint32_t idIndex = IF_ID.pc / 4;
+                    if (!statsOnly && idIndex < instructionMemory.size()) {
+                        recorder.record(currentCycle, idIndex, Stage::ID,
+                                        assemblyText(idIndex), assemblyLength(idIndex));
+                    }
+                }
+                nextIdEx.isNop = true;
+                hasDataHazard = true;
+            }
+            else {
+                if (hazardIndicator == 2) {
+                    skipFetch = false;
+                    hasDataHazard = true;
+                } else {
+                    uint32_t idIndex = IF_ID.pc / 4;
+                    if (!statsOnly && idIndex < instructionMemory.size()) {
+                        recorder.record(currentCycle, idIndex, Stage::ID,
+                                        assemblyText(idIndex), assemblyLength(idIndex));
+                    }
+                    hasDataHazard = false;
+                }
+
+                // Copy the predecoded instruction and stamp in the
+                // per-fetch fields
+                nextIdEx = decodedInstruction;
+                nextIdEx.pc = IF_ID.pc;
+                nextIdEx.fetchCycle = IF_ID.fetchCycle;
+                nextIdEx.predictedTaken = IF_ID.predictedTaken;
+                nextIdEx.predictedTarget = IF_ID.predictedTarget;
+
+                // Determine if it is an I-type instruction
+                nextIdEx.uop.isIType = (decodedInstruction.uop.op == AluOp::ADDI ||
+                                        decodedInstruction.uop.op == AluOp::LB ||
+                                        decodedInstruction.uop.op == AluOp::JALR);
+
+                // Post-decode write-enable override, policy-specific
+                nextIdEx.uop.writeEnable =
+                    Policy::writeEnableAfterDecode(decodedInstruction.uop.op) ? 1 : 0;
+            }
+        }
+
+        // --------------------- IF Stage ---------------------
+        IF_ID_Reg nextIfId = {};
+
+        if (!isBranchTaken) {
+            if (hasDataHazard) {
+                if (skipFetch && hazardIndicator == 0) {
+                    uint32_t currentIndex = programCounter / 4;
+                    if (currentIndex < instructionMemory.size()) {
+                        nextIfId = IF_ID;
+                        if (!statsOnly) {
+                            recorder.record(currentCycle, currentIndex, Stage::IF,
+                                            assemblyText(currentIndex), assemblyLength(currentIndex));
+                        }
+                    }
+                    else {
+                        nextIfId = IF_ID;
+                    }
+                }
+                else if (skipFetch && hazardIndicator == 1) {
+                    nextIfId = IF_ID;
+                }
+                else if (!skipFetch && hazardIndicator == 2) {
+                    uint32_t currentIndex = programCounter / 4;
+                    if (currentIndex < instructionMemory.size()) {
+                        nextIfId.instruction = instructionMemory[currentIndex].machineCode;
+                        nextIfId.isNop = false;
+                        nextIfId.pc = programCounter;
+                        nextIfId.fetchCycle = currentCycle;
+                        uint32_t predictedTarget = 0;
+                        if (predictor.predict(programCounter, predictedTarget)) {
+                            // Redirect the fetch stream at once; EX verifies later
+                            nextIfId.predictedTaken = true;
+                            nextIfId.predictedTarget = predictedTarget;
+                            programCounter = predictedTarget;
+                        } else {
+                            programCounter += 4;
+                        }
+                    } else {
+                        nextIfId.isNop = true;
+                    }
+                }
+            }
+            else {
+                uint32_t currentIndex = programCounter / 4;
+                if (currentIndex < instructionMemory.size()) {
+                    nextIfId.instruction = instructionMemory[currentIndex].machineCode;
+                    nextIfId.isNop = false;
+                    nextIfId.pc = programCounter;
+                    nextIfId.fetchCycle = currentCycle;
+                    uint32_t predictedTarget = 0;
+                    if (predictor.predict(programCounter, predictedTarget)) {
+                        // Redirect the fetch stream at once; EX verifies later
+                        nextIfId.predictedTaken = true;
+                        nextIfId.predictedTarget = predictedTarget;
+                        programCounter = predictedTarget;
+                    } else {
+                        programCounter += 4;
+                    }
+                    if (!statsOnly) {
+                        recorder.record(currentCycle, currentIndex, Stage::IF,
+                                        assemblyText(currentIndex), assemblyLength(currentIndex));
+                    }
+                } else {
+                    nextIfId.isNop = true;
+                }
+            }
+        }
+
+        if (isBranchTaken) {
+            programCounter = targetPC;           // Update PC to target
+            nextIfId.pc = programCounter;
+            nextIdEx.isNop = true;
+            nextIdEx.destReg = 2400;
+            nextIfId.isNop = true;
+            isBranchTaken = false;
+        }
+
+        // --------------------- Pipeline Register Update ---------------------
+        MEM_WB = nextMemWb;
+        EX_MEM = nextExMem;
+        ID_EX = nextIdEx;
+        IF_ID = nextIfId;
+
+        currentCycle++;
+    }
+
+    stats.totalCycles = cycleCount;
+    lastRunStats = stats;
+    if (statsOnly) {
+        stats.print(std::cout);
+        predictor.printStats(std::cout);
+    } else {
+        // Stream the rows still in flight when the cycle budget ran out
+        recorder.finish();
+        // In diagram mode only report the predictor when it is actually on,
+        // so the baseline output stays unchanged
+        if (predictor.enabled()) {
+            predictor.printStats(std::cout);
+        }
+    }
+    // Combined report: cache counters alongside the pipeline statistics
+    if (dataCache != nullptr) {
+        dataCache->printStats(std::cout);
+    }
+}
+
+#endif // PROCESSOR_HPP
@@ -0,0 +1,121 @@
+#include "Forwarding.hpp"
+#include "NonForwarding.hpp"
+#include <chrono>
+#include <iostream>
+#include <streambuf>
+#include <string>
+
+// Benchmark harness (built by `make bench`): runs the input-file corpus
+// through both processors, checks the retired/stall counts against the
+// known-good values below, and reports simulated instructions per host
+// second for each. Any mismatch fails the run with a nonzero exit code.
+
+// Discards everything written to it; used to silence the simulators'
+// normal diagram/stats output during the timed runs
+struct NullStreamBuffer : std::streambuf {
+    int overflow(int character) { return character; }
+};
+
+struct BenchCase {
+    const char* inputFile;
+    uint64_t expectedRetiredForwarding;
+    uint64_t expectedStallsForwarding;
+    uint64_t expectedRetiredBasic;
+    uint64_t expectedStallsBasic;
+};
+
+// Known-good counts for a 25-cycle simulation of each corpus file
+static const BenchCase benchCases[] = {
+    {"../inputfiles/arithmetic.txt",         7, 0,  7, 4},
+    {"../inputfiles/complex_arithmetic.txt", 11, 0, 11, 4},
+    {"../inputfiles/input.txt",              4, 0,  4, 2},
+    {"../inputfiles/loads.txt",              6, 2,  6, 6},
+    {"../inputfiles/stringcopy.txt",         0, 0,  0, 0},
+    {"../inputfiles/strlen.txt",             4, 0,  4, 2},
+    {"../inputfiles/t.txt",                  0, 0,  0, 0},
+};
+
+static const uint32_t CYCLE_BUDGET = 25;
+static const int TIMED_REPEATS = 20000;
+
+static bool checkCounts(const std::string& label, const char* inputFile,
+                        const PipelineStats& actual,
+                        uint64_t expectedRetired, uint64_t expectedStalls) {
+    if (actual.totalCycles != CYCLE_BUDGET) {
+        std::cerr << "FAIL " << inputFile << " [" << label << "]: simulated "
+                  << actual.totalCycles << " cycles, expected " << CYCLE_BUDGET << std::endl;
+        return false;
+    }
+    if (actual.retired != expectedRetired || actual.stallCycles != expectedStalls) {
+        std::cerr << "FAIL " << inputFile << " [" << label << "]: retired "
+                  << actual.retired << " (expected " << expectedRetired
+                  << "), stalls " << actual.stallCycles
+                  << " (expected " << expectedStalls << ")" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    NullStreamBuffer nullBuffer;
+    bool allPassed = true;
+    uint64_t totalInstructions = 0;
+    double totalSeconds = 0.0;
+
+    for (const BenchCase& benchCase : benchCases) {
+        // Construct once per file; each timed iteration re-runs the same
+        // cycle budget, so file I/O and predecode stay out of the loop
+        std::streambuf* savedBuffer = std::cout.rdbuf(&nullBuffer);
+        NoForwardProcessor forwardingProcessor(benchCase.inputFile, true);
+        BasicProcessor basicProcessor(benchCase.inputFile, true);
+
+        // Correctness check: one run of each, compared against the table
+        forwardingProcessor.simulate(CYCLE_BUDGET);
+        basicProcessor.simulate(CYCLE_BUDGET);
+        std::cout.rdbuf(savedBuffer);
+
+        allPassed &= checkCounts("forwarding", benchCase.inputFile,
+                                 forwardingProcessor.lastStats(),
+                                 benchCase.expectedRetiredForwarding,
+                                 benchCase.expectedStallsForwarding);
+        allPassed &= checkCounts("basic", benchCase.inputFile,
+                                 basicProcessor.lastStats(),
+                                 benchCase.expectedRetiredBasic,
+                                 benchCase.expectedStallsBasic);
+
+        // Timed runs: report simulated instructions per host second
+        savedBuffer = std::cout.rdbuf(&nullBuffer);
+        auto startForwarding = std::chrono::steady_clock::now();
+        for (int i = 0; i < TIMED_REPEATS; ++i) {
+            forwardingProcessor.simulate(CYCLE_BUDGET);
+        }
+        auto endForwarding = std::chrono::steady_clock::now();
+        auto startBasic = std::chrono::steady_clock::now();
+        for (int i = 0; i < TIMED_REPEATS; ++i) {
+            basicProcessor.simulate(CYCLE_BUDGET);
+        }
+        auto endBasic = std::chrono::steady_clock::now();
+        std::cout.rdbuf(savedBuffer);
+
+        double secondsForwarding = std::chrono::duration<double>(endForwarding - startForwarding).count();
+        double secondsBasic = std::chrono::duration<double>(endBasic - startBasic).count();
+        uint64_t instructionsForwarding = benchCase.expectedRetiredForwarding * TIMED_REPEATS;
+        uint64_t instructionsBasic = benchCase.expectedRetiredBasic * TIMED_REPEATS;
+        totalInstructions += instructionsForwarding + instructionsBasic;
+        totalSeconds += secondsForwarding + secondsBasic;
+
+        std::cout << benchCase.inputFile
+                  << " forwarding: " << (secondsForwarding > 0 ? instructionsForwarding / secondsForwarding : 0)
+                  << " instr/s, basic: " << (secondsBasic > 0 ? instructionsBasic / secondsBasic : 0)
+                  << " instr/s" << std::endl;
+    }
+
+    if (!allPassed) {
+        std::cerr << "Benchmark FAILED: cycle count mismatch" << std::endl;
+        return 1;
+    }
+    std::cout << "All cycle counts match. Overall: "
+              << (totalSeconds > 0 ? totalInstructions / totalSeconds : 0)
+              << " simulated instr/s" << std::endl;
+    return 0;
+}
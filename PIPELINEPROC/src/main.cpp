@@ -1,17 +1,83 @@
 #include "Forwarding.hpp"
+#include "BatchRunner.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 
 int main(int argc, char* argv[]) {
     if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <input_file>" << std::endl;
+        std::cerr << "Usage: " << argv[0]
+                  << " <input_file> [--stats] [--bp[=entries]] [--cache[=s:E:b]]\n"
+                  << "       " << argv[0]
+                  << " --batch <list_file> [--cycles=N] [--jobs=N]" << std::endl;
         return 1;
     }
 
+    // Batch mode: run every program in the list file across a thread
+    // pool and print one consolidated results table
+    if (std::strcmp(argv[1], "--batch") == 0) {
+        if (argc < 3) {
+            std::cerr << "Usage: " << argv[0]
+                      << " --batch <list_file> [--cycles=N] [--jobs=N]" << std::endl;
+            return 1;
+        }
+        std::string listFile = argv[2];
+        uint32_t cycleBudget = 25;
+        unsigned int jobCount = 0;   // 0 = one thread per hardware core
+        for (int i = 3; i < argc; ++i) {
+            if (std::strncmp(argv[i], "--cycles=", 9) == 0) {
+                cycleBudget = (uint32_t)std::strtoul(argv[i] + 9, nullptr, 10);
+            } else if (std::strncmp(argv[i], "--jobs=", 7) == 0) {
+                jobCount = (unsigned int)std::strtoul(argv[i] + 7, nullptr, 10);
+            } else {
+                std::cerr << "Unknown option: " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        return BatchRunner::run(listFile, cycleBudget, jobCount);
+    }
+
     std::string inputFile = argv[1];
-    NoForwardProcessor processor(inputFile);
+    // --stats: skip the pipeline diagram and report only cycle/stall/CPI counters
+    // --bp[=entries]: enable the 2-bit/BTB branch predictor (default 256 entries)
+    // --cache[=s:E:b]: route MEM accesses through the CACHE model
+    //                  (set index bits : associativity : block offset bits)
+    bool statsOnly = false;
+    bool predictorEnabled = false;
+    size_t predictorEntries = 256;
+    bool cacheEnabled = false;
+    int cacheSetBits = 6, cacheAssoc = 2, cacheBlockBits = 5;
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--stats") == 0) {
+            statsOnly = true;
+        } else if (std::strncmp(argv[i], "--bp", 4) == 0) {
+            predictorEnabled = true;
+            if (argv[i][4] == '=') {
+                predictorEntries = std::strtoul(argv[i] + 5, nullptr, 10);
+                if (predictorEntries == 0) predictorEntries = 256;
+            }
+        } else if (std::strncmp(argv[i], "--cache", 7) == 0) {
+            cacheEnabled = true;
+            if (argv[i][7] == '=' &&
+                std::sscanf(argv[i] + 8, "%d:%d:%d",
+                            &cacheSetBits, &cacheAssoc, &cacheBlockBits) != 3) {
+                std::cerr << "Invalid cache geometry: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else {
+            std::cerr << "Unknown option: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    NoForwardProcessor processor(inputFile, statsOnly, predictorEnabled, predictorEntries);
+    if (cacheEnabled) {
+        processor.attachCache(cacheSetBits, cacheAssoc, cacheBlockBits);
+    }
 
     // Simulate the processor for a specified number of cycles (e.g., 10)
     processor.simulate(25);
 
     return 0;
-}
\ No newline at end of file
+}